@@ -1,2718 +1,6550 @@
-/*
- * EXORCISM - Ladder Test Data Validation System
- * Copyright (c) 2025 Nikodem Witkowski
- * Licensed under the MIT License
- * 
- * This program performs comprehensive validation of ladder test data
- * directory structures and files. It checks for required files, naming conventions,
- * content validity, and generates detailed reports before/after cleanup operations.
- */
-
-// Standard C++ Library Headers
-#include <iostream>   // For console input/output operations
-#include <fstream>    // For file stream operations
-#include <vector>     // For dynamic array functionality
-#include <string>     // For string manipulation
-#include <sstream>    // For string stream processing
-#include <iomanip>    // For output formatting
-#include <ctime>      // For date/time functions
-#include <map>        // For key-value pair storage
-#include <algorithm>  // For sorting/searching algorithms
-#include <set>        // For unique element storage
-
-// ROOT Framework Headers (Data Analysis)
-#include <TSystem.h>              // System interface utilities
-#include <TString.h>              // ROOT string implementation
-#include <TSystemDirectory.h>     // Directory handling
-#include <TSystemFile.h>          // File handling
-#include <TList.h>                // Linked list container
-#include <TFile.h>                // ROOT file I/O operations
-#include <TCanvas.h>              // Drawing canvas
-#include <TLatex.h>               // LaTeX text rendering
-#include <TPie.h>                 // Pie chart visualization
-#include <TLegend.h>              // Chart legend
-#include <TObjString.h>           // String object wrapper
-#include <TInterpreter.h>         // C++ interpreter
-#include <TPaveText.h>            // Text box widget
-
-// ===================================================================
-// Global Constants and Structures
-// ===================================================================
-
-/*
- * Evaluation Status Levels:
- * These constants define the possible validation outcomes
- */
-#define STATUS_DATA_CONSISTENT                  0       // All checks successful
-#define STATUS_DATA_INCONSISTENT_AUXILIARY      1       // Auxiliary files found but not critical
-#define STATUS_DATA_INCONSISTENT_MISSING_EXTRA  2       // Missing/Extra files error
-#define STATUS_DIRECTORY_ERROR                  3       // Directory access error
-
-/*
- * Log Files Validation Flags (Bitmask):
- * Each flag represents a specific validation failure condition
- */
-#define FLAG_DIR_MISSING         0x01   // Target directory not found
-#define FLAG_LOG_MISSING         0x02   // Main log file missing
-#define FLAG_DATA_MISSING        0x04   // Required data files missing
-#define FLAG_NO_FEB_FILE         0x08   // Matching tester FEB file missing
-#define FLAG_FILE_OPEN           0x10   // File access error
-#define FLAG_DATA_EMPTY          0x20   // Empty data file
-#define FLAG_DATA_INVALID        0x40   // Invalid file content
-#define FLAG_UNEXPECTED_FILES    0x80   // Unexpected files in directory
-
-/*
- * Connection Files Validation Flags:
- * Specific flags for connection test files
- */
-#define FLAG_CONN_FOLDER_MISSING 0x01   // conn_check_files directory missing
-#define FLAG_DIR_ACCESS          0x02   // Directory access error
-#define FLAG_ELECTRON_COUNT      0x04   // Incorrect electron file count
-#define FLAG_HOLE_COUNT          0x08   // Incorrect hole file count
-#define FLAG_FILE_OPEN_CONN      0x10   // Connection file access error
-#define FLAG_UNEXPECTED_FILES_CONN 0x20 // Unexpected files in connection dir
-
-/*
- * Trim Files Validation Flags:
- * Specific flags for trim adjustment files
- */
-#define FLAG_TRIM_FOLDER_MISSING 0x01   // trim_files directory missing
-#define FLAG_DIR_ACCESS_TRIM     0x02   // Directory access error
-#define FLAG_ELECTRON_COUNT_TRIM 0x04   // Incorrect electron file count
-#define FLAG_HOLE_COUNT_TRIM     0x08   // Incorrect hole file count
-#define FLAG_FILE_OPEN_TRIM      0x10   // Trim file access error
-#define FLAG_UNEXPECTED_FILES_TRIM 0x20 // Unexpected files in trim dir
-
-/*
- * Pscan Files Validation Flags:
- * Specific flags for parameter scan files
- */
-#define FLAG_PSCAN_FOLDER_MISSING 0x01  // pscan_files directory missing
-#define FLAG_DIR_ACCESS_PSCAN    0x02   // Directory access error
-#define FLAG_ELECTRON_TXT        0x04   // Incorrect electron txt count
-#define FLAG_HOLE_TXT            0x08   // Incorrect hole txt count
-#define FLAG_ELECTRON_ROOT       0x10   // Incorrect electron root count
-#define FLAG_HOLE_ROOT           0x20   // Incorrect hole root count
-#define FLAG_FILE_OPEN_PSCAN     0x40   // Pscan file access error
-#define FLAG_UNEXPECTED_FILES_PSCAN 0x80 // Unexpected files in pscan dir
-#define FLAG_MODULE_ROOT         0x100  // Module root file error
-#define FLAG_MODULE_TXT          0x200  // Module text file error
-#define FLAG_MODULE_PDF          0x400  // Module PDF file missing
-
-/*
- * ValidationResult Structure:
- * Contains all validation results for a single test directory
- */
-struct ValidationResult {
-    int flags = 0;  // Bitmask of encountered issues
-    
-    // Error file collections
-    std::vector<std::string> openErrorFiles;    // Files that couldn't be opened
-    std::vector<std::string> unexpectedFiles;   // Unexpected files found
-    std::vector<std::string> emptyFiles;        // Empty files found
-    std::vector<std::string> invalidFiles;      // Files with invalid content
-    std::vector<std::string> moduleErrorFiles;  // Module test file errors
-    
-    // Log files specific counters
-    int dataFileCount = 0;      // Total data files found
-    int nonEmptyDataCount = 0;  // Non-empty data files
-    int validDataCount = 0;     // Data files with valid content
-    bool foundFebFile = true;   // Found matching tester FEB file
-    bool logExists = false;     // Main log file exists
-    
-    // Trim/Conn files specific counters
-    int electronCount = 0;      // Electron files found
-    int holeCount = 0;          // Hole files found
-    
-    // Pscan files specific counters
-    int electronTxtCount = 0;   // Electron text files
-    int holeTxtCount = 0;       // Hole text files
-    int electronRootCount = 0;  // Electron root files
-    int holeRootCount = 0;      // Hole root files
-};
-
-/*
- * GlobalState Structure:
- * Tracks overall validation state across all directories
- */
-struct GlobalState {
-    std::vector<std::string> reportPages;   // Individual directory reports
-    std::string globalSummary;              // Consolidated summary
-    int goodDirs = 0;                       // Count of good quality directories
-    int auxDirs = 0;                        // Count of directories with auxiliary files
-    int missextraDirs = 0;                  // Count of directories with missing/extra files 
-    int errorDirs = 0;                      // Count of directories ith access errors
-    std::string currentLadder;             // Current working directory name
-};
-
-GlobalState gState;  // Global state instance
-
-// ===================================================================
-// Helper Functions
-// ===================================================================
-
-/*
- * DirectoryExists:
- * Checks if a directory exists at the given path
- */
-bool DirectoryExists(const TString& path) {
-    return !gSystem->AccessPathName(path, kFileExists);
-}
-
-/*
- * GetDirectoryListing:
- * Returns a list of files in the specified directory
- */
-TList* GetDirectoryListing(const TString& path) {
-    TSystemDirectory dir(path, path);
-    return dir.GetListOfFiles();
-}
-
-/*
- * CheckFileAccess:
- * Verifies if a file can be opened and tracks failures
- */
-bool CheckFileAccess(const TString& filePath, std::vector<std::string>& errorList) {
-    std::ifstream file(filePath.Data());
-    if (!file.is_open()) {
-        errorList.push_back(gSystem->BaseName(filePath.Data()));
-        return false;
-    }
-    file.close();
-    return true;
-}
-
-/*
- * CheckRootFile:
- * Verifies if a ROOT file can be opened properly
- */
-bool CheckRootFile(const TString& filePath, std::vector<std::string>& errorList) {
-    TFile* file = TFile::Open(filePath, "READ");
-    if (!file || file->IsZombie()) {
-        errorList.push_back(gSystem->BaseName(filePath.Data()));
-        if (file) delete file;
-        return false;
-    }
-    delete file;
-    return true;
-}
-
-/*
- * CheckDataFileContent:
- * Verifies if the content of a .dat file meets expected patterns
- */
-bool CheckDataFileContent(const char* filePath) {
-    std::ifstream file(filePath);
-    if (!file.is_open()) {
-        return false;
-    }
-
-    std::string line;
-    while (std::getline(file, line)) {
-        if (line.find("LV_AFT_CONFIG_P") != std::string::npos) {
-            int validLinesAfter = 0;
-            while (std::getline(file, line)) {
-                if (line.find_first_not_of(" \t") == std::string::npos) {
-                    continue;
-                }
-                validLinesAfter++;
-                if (validLinesAfter >= 2) {
-                    return true;
-                }
-            }
-            break;
-        }
-    }
-    return false;
-}
-
-// ===================================================================
-// Validation Functions
-// ===================================================================
-
-/*
- * CheckLogFiles:
- * Validates the log files and data files in a test directory
- * 
- * Parameters:
- *   targetDir - Name of the directory to validate
- * 
- * Returns:
- *   ValidationResult containing all findings
- * 
- * Checks:
- * 1. Directory existence
- * 2. Presence of main log file (<dir>_log.log)
- * 3. Data files (*_data.dat) existence and content
- * 4. Matching tester FEB files (tester_febs_*)
- * 5. File naming conventions with timestamps
- * 6. File accessibility and content validity
- */
-ValidationResult CheckLogFiles(const char* targetDir) {
-    ValidationResult result;
-    TString currentDir = gSystem->pwd();
-    TString fullTargetPath = TString::Format("%s/%s", currentDir.Data(), targetDir);
-
-    // PRIMARY CHECK: Verify existence of target directory
-    if (gSystem->AccessPathName(fullTargetPath, kFileExists)) {
-        std::cerr << "\n===== CRITICAL ERROR =====" << std::endl;
-        std::cerr << "Target directory does not exist: " << fullTargetPath << std::endl;
-        result.flags |= FLAG_DIR_MISSING;
-        return result; // Can't proceed if directory is missing
-    }
-
-    /* Check for existence and accessibility of the primary log file */
-    TString logFilePath = TString::Format("%s/%s_log.log", fullTargetPath.Data(), targetDir);
-    if (!gSystem->AccessPathName(logFilePath, kFileExists)) {
-        result.logExists = true;
-        if (!CheckFileAccess(logFilePath, result.openErrorFiles)) {
-            std::cerr << "Error: Cannot open log file: " << logFilePath << std::endl;
-            result.flags |= FLAG_FILE_OPEN;
-        }
-    } else {
-        std::cerr << "Error: Log file does not exist: " << logFilePath << std::endl;
-        result.flags |= FLAG_LOG_MISSING;
-    }
-
-    // Directory traversal
-    TSystemDirectory targetDirObj(targetDir, fullTargetPath);
-    TList* files = targetDirObj.GetListOfFiles();
-    if (!files) {
-        std::cerr << "Error: Could not read directory contents: " << fullTargetPath << std::endl;
-        result.flags |= FLAG_FILE_OPEN;
-        return result;
-    }
-
-    // Structure to store discovered files with their metadata
-    struct FileInfo {
-        TString fullPath;         // Complete file path
-        TString fileName;         // Just the filename
-        TString dateTimePattern;  // Extracted timestamp (YYMMDD_HHMM)
-        bool isSpecialCase;       // Flag for files without timestamp
-    };
-
-    std::vector<FileInfo> dataFiles;    // Stores all found data files
-    std::vector<FileInfo> testerFiles;  // Stores all found tester FEB files
-
-    // ===================================================================
-    // FILE PROCESSING LOOP
-    // ===================================================================
-    TSystemFile* file;
-    TIter next(files);
-    while ((file = (TSystemFile*)next())) {
-        TString fileName = file->GetName();
-
-        // Skip directories and special files
-        if (file->IsDirectory() || fileName == "." || fileName == "..") continue;
-    
-        TString fullFilePath = fullTargetPath + "/" + fileName;
-        bool isExpectedFile = false;
-
-        // Skip the log file we already processed
-        if (fileName == TString::Format("%s_log.log", targetDir)) {
-            continue;
-        }
-
-        // Check for data files (two possible formats)
-        if (fileName.BeginsWith(targetDir) && fileName.EndsWith("_data.dat")) {
-            isExpectedFile = true;
-            result.dataFileCount++;
-            
-            FileInfo info;
-            info.fullPath = fullFilePath;
-            info.fileName = fileName;
-            info.isSpecialCase = false;
-
-            // Check for standard format: "folder_YYMMDD_HHMM_data.dat"
-            if (fileName.Length() == (15 + 1 + 6 + 1 + 4 + 9)) { // 15 (folder) + _ + 6 (YYMMDD) + _ + 4 (HHMM) + _data.dat
-                info.dateTimePattern = fileName(16, 11); // Extract YYMMDD_HHMM
-            } 
-            // Check for special case: "folder_data.dat"
-            else if (fileName == TString::Format("%s_data.dat", targetDir)) {
-                info.isSpecialCase = true;
-            } else {
-                std::cerr << "Warning: Unexpected data file format: " << fileName << std::endl;
-                result.unexpectedFiles.push_back(fileName.Data());
-                result.flags |= FLAG_UNEXPECTED_FILES;
-                continue; // Skip further processing for malformed names
-            }
-            
-            dataFiles.push_back(info);
-            
-            // DATA FILE CONTENT VALIDATION
-            std::ifstream f_data(fullFilePath.Data(), std::ios::binary | std::ios::ate);
-            if (!f_data.is_open()) {
-                std::cerr << "Error: Cannot open data file: " << fullFilePath << std::endl;
-                result.openErrorFiles.push_back(fileName.Data());
-                result.flags |= FLAG_FILE_OPEN;
-            } else {
-                // Check file size first (quick check)
-                std::streampos size = f_data.tellg();
-                f_data.close();
-                
-                if (size > 0) {
-                    result.nonEmptyDataCount++;
-                    // Perform detailed content validation
-                    if (CheckDataFileContent(fullFilePath.Data())) {
-                        result.validDataCount++;
-                    } else {
-                        std::cerr << "Error: Invalid content in data file: " << fullFilePath << std::endl;
-                        result.invalidFiles.push_back(fileName.Data());
-                        result.flags |= FLAG_DATA_INVALID;
-                    }
-                } else {
-                    std::cerr << "Warning: Empty data file: " << fullFilePath << std::endl;
-                    result.emptyFiles.push_back(fileName.Data());
-                    result.flags |= FLAG_DATA_EMPTY;
-                }
-            }
-        }
-        // TESTER FEB FILE PROCESSING
-        else if (fileName.BeginsWith("tester_febs_") && fileName.Contains("_arr_")) {
-            isExpectedFile = true;
-            
-            FileInfo info;
-            info.fullPath = fullFilePath;
-            info.fileName = fileName;
-            info.isSpecialCase = false;
-            
-            // Extract timestamp from FEB filename (format: tester_febs_*_arr_YYMMDD_HHMM*)
-            Ssiz_t arrPos = fileName.Index("_arr_");
-            if (arrPos != kNPOS && fileName.Length() >= arrPos + 5 + 11) {
-                info.dateTimePattern = fileName(arrPos + 5, 11); // Extract YYMMDD_HHMM
-            } else {
-                std::cerr << "Warning: Invalid FEB file format: " << fileName << std::endl;
-                result.unexpectedFiles.push_back(fileName.Data());
-                result.flags |= FLAG_UNEXPECTED_FILES;
-                continue;
-            }
-            
-            testerFiles.push_back(info);
-        }
-
-        // UNEXPECTED FILE HANDLING
-        if (!isExpectedFile) {
-            std::cerr << "Warning: Unexpected file found: " << fullFilePath << std::endl;
-            result.unexpectedFiles.push_back(fileName.Data());
-            result.flags |= FLAG_UNEXPECTED_FILES;
-        }
-    }
-
-    delete files; // Clean up directory listing
-
-    // ===================================================================
-    // DATA-TESTER FILE MATCHING
-    // ===================================================================
-    /* This complex matching handles two scenarios:
-     * 1. Normal case: Data file with timestamp matches tester file with same timestamp
-     * 2. Special case: Untimestamped data file matches with oldest available tester file
-     */
-    
-    // Sort tester files chronologically (oldest first)
-    std::sort(testerFiles.begin(), testerFiles.end(), [](const FileInfo& a, const FileInfo& b) {
-        return a.dateTimePattern < b.dateTimePattern;
-    });
-
-    // Track which tester files have been matched
-    std::vector<bool> matchedTesters(testerFiles.size(), false);
-    int specialCaseMatchIndex = -1;
-
-    for (auto& dataFile : dataFiles) {
-        bool foundMatch = false;
-        
-        // Special case handling (data file without timestamp)
-        if (dataFile.isSpecialCase) {
-            // Find the oldest unmatched tester file
-            for (size_t i = 0; i < testerFiles.size(); i++) {
-                if (!matchedTesters[i]) {
-                    matchedTesters[i] = true;
-                    foundMatch = true;
-                    specialCaseMatchIndex = i;
-                    std::cerr << "Info: Special case data file " << dataFile.fileName 
-                              << " matched with oldest available tester file " << testerFiles[i].fileName 
-                              << " (pattern: " << testerFiles[i].dateTimePattern << ")" << std::endl;
-                    break;
-                }
-            }
-        } else {
-            // Normal case - match by exact timestamp
-            for (size_t i = 0; i < testerFiles.size(); i++) {
-                if (!matchedTesters[i] && dataFile.dateTimePattern == testerFiles[i].dateTimePattern) {
-                    matchedTesters[i] = true;
-                    foundMatch = true;
-                    std::cerr << "Info: Data file " << dataFile.fileName 
-                              << " matched with tester file " << testerFiles[i].fileName 
-                              << " (pattern: " << dataFile.dateTimePattern << ")" << std::endl;
-                    break;
-                }
-            }
-        }
-        
-        // No match found for this data file
-        if (!foundMatch) {
-            std::cerr << "Error: No matching tester file found for data file: " 
-                      << dataFile.fileName;
-            if (!dataFile.isSpecialCase) {
-                std::cerr << " (pattern: " << dataFile.dateTimePattern << ")";
-            }
-            std::cerr << std::endl;
-            result.flags |= FLAG_NO_FEB_FILE;
-        }
-
-        result.foundFebFile &= foundMatch; // Update overall FEB file match status
-    }
-
-    // Final check if we have data files but no FEB files at all
-    if (dataFiles.size() > 0 && testerFiles.size() == 0) {
-        std::cerr << "Error: No FEB files found in directory" << std::endl;
-        result.flags |= FLAG_NO_FEB_FILE;
-    }
-
-    // ===================================================================
-    // REPORT GENERATION
-    // ===================================================================
-    std::cout << "\n===== Log Files Status =====" << std::endl;
-    std::cout << "Log file:         " << (result.logExists ? "FOUND" : "MISSING") 
-              << (result.flags & FLAG_FILE_OPEN ? " (OPEN ERROR)" : "") << std::endl;
-    std::cout << "Data files:       " << result.dataFileCount << " found | "
-              << (result.flags & FLAG_DATA_MISSING ? "NONE" : 
-                 (result.flags & FLAG_DATA_EMPTY) ? "SOME EMPTY" :
-                 (result.flags & FLAG_DATA_INVALID) ? "SOME INVALID" : "VALID") << std::endl;
-    std::cout << "Non-empty files:  " << result.nonEmptyDataCount << "/" << result.dataFileCount << std::endl;
-    std::cout << "Valid files:      " << result.validDataCount << "/" << result.dataFileCount << std::endl;
-    std::cout << "Tester FEB files: " << testerFiles.size() << " found | "
-              << (result.flags & FLAG_NO_FEB_FILE ? "MISSING MATCHES" : "ALL MATCHED") << std::endl;
-
-    if (!result.emptyFiles.empty()) {
-        std::cout << "\n===== Empty Data Files =====" << std::endl;
-        for (const auto& file : result.emptyFiles) {
-            std::cout << " - " << file << std::endl;
-        }
-    }
-
-    if (!result.invalidFiles.empty()) {
-        std::cout << "\n===== Invalid Data Files =====" << std::endl;
-        for (const auto& file : result.invalidFiles) {
-            std::cout << " - " << file << std::endl;
-        }
-    }
-
-    if (!result.openErrorFiles.empty()) {
-        std::cout << "\n===== File Open Errors =====" << std::endl;
-        for (const auto& file : result.openErrorFiles) {
-            std::cout << " - " << file << std::endl;
-        }
-    }
-
-    if (!result.unexpectedFiles.empty()) {
-        std::cout << "\n===== Unexpected Files =====" << std::endl;
-        for (const auto& file : result.unexpectedFiles) {
-            std::cout << " - " << file << std::endl;
-        }
-    }
-
-    std::cout << "\nSummary: ";
-    if (result.flags == 0) {
-        std::cout << "ALL CHECKS PASSED";
-    } else {
-        if (result.flags & FLAG_DIR_MISSING) std::cout << "[DIR MISSING] ";
-        if (result.flags & FLAG_LOG_MISSING) std::cout << "[LOG MISSING] ";
-        if (result.flags & FLAG_DATA_MISSING) std::cout << "[DATA MISSING] ";
-        if (result.flags & FLAG_NO_FEB_FILE) std::cout << "[NO FEB FILES] ";
-        if (result.flags & FLAG_FILE_OPEN) std::cout << "[FILE OPEN ERROR] ";
-        if (result.flags & FLAG_DATA_EMPTY) std::cout << "[DATA EMPTY] ";
-        if (result.flags & FLAG_DATA_INVALID) std::cout << "[DATA INVALID] ";
-        if (result.flags & FLAG_UNEXPECTED_FILES) std::cout << "[UNEXPECTED FILES]";
-    }
-    std::cout << std::endl;
-
-    return result;
-}
-
-/*
- * CheckTrimFiles:
- * Validates the trim adjustment files in the 'trim_files' subdirectory.
- * Ensures proper count and naming convention of electron and hole trim files.
- * 
- * Parameters:
- *   targetDir - Parent directory containing trim_files
- * 
- * Returns:
- *   ValidationResult with trim file findings
- * 
- * Checks:
- * 1. trim_files subdirectory existence
- * 2. Exactly 8 electron files (*_elect.txt)
- * 3. Exactly 8 hole files (*_holes.txt)
- * 4. Proper HW index format (0-7) in filenames
- * 5. No duplicate HW indices
- * 6. File accessibility
- * 7. No unexpected files in directory
- */
-ValidationResult CheckTrimFiles(const char* targetDir) {
-    ValidationResult result;
-    TString currentDir = gSystem->pwd();
-    TString fullTargetPath = TString::Format("%s/%s", currentDir.Data(), targetDir);
-    TString trimDirPath = TString::Format("%s/%s/trim_files", currentDir.Data(), targetDir);
-
-    // PRIMARY CHECK: Verify existence of 'trim_files' directory
-    if (gSystem->AccessPathName(trimDirPath, kFileExists)) {
-        std::cerr << "\n===== CRITICAL ERROR =====" << std::endl;
-        std::cerr << "Directory 'trim_files' does not exist in target folder!" << std::endl;
-        std::cerr << "Target folder: " << fullTargetPath << std::endl;
-        std::cerr << "Expected path: " << trimDirPath << std::endl;
-        result.flags |= FLAG_TRIM_FOLDER_MISSING;
-        return result;
-    }
-
-    // DIRECTORY SCANNING INITIALIZATION
-    TList* files = GetDirectoryListing(trimDirPath);
-    if (!files) {
-        std::cerr << "Error: Could not read directory contents: " << trimDirPath << std::endl;
-        result.flags |= FLAG_DIR_ACCESS_TRIM;
-        return result;
-    }
-
-    // ===================================================================
-    // HW INDEX TRACKING SETUP
-    // ===================================================================
-    /* We need exactly 8 files each for electrons and holes (HW indices 0-7) */
-    std::set<int> foundElectronIndices;  // Tracks found electron HW indices
-    std::set<int> foundHoleIndices;      // Tracks found hole HW indices
-
-    // ===================================================================
-    // FILE PROCESSING LOOP
-    // ===================================================================
-    TSystemFile* file;
-    TIter next(files);
-    while ((file = (TSystemFile*)next())) {
-        TString fileName = file->GetName();
-
-        // Skip directories and special files
-        if (file->IsDirectory() || fileName == "." || fileName == "..") continue;
-        
-        TString fullFilePath = trimDirPath + "/" + fileName;
-
-        // =================================================================
-        // ELECTRON FILE PROCESSING
-        // =================================================================
-        if (fileName.EndsWith("_elect.txt")) {
-            // Extract HW index from filename (format: *_HW_X_SET_*_elect.txt)
-            Ssiz_t hwPos = fileName.Index("_HW_");
-            Ssiz_t setPos = fileName.Index("_SET_", hwPos+4);
-            
-            // Validate filename format
-            if (hwPos == -1 || setPos == -1 || setPos <= hwPos+4) {
-                std::cerr << "Error: Invalid electron file name format: " << fileName << std::endl;
-                result.invalidFiles.push_back(fileName.Data());
-                result.flags |= FLAG_DATA_INVALID;
-                continue;
-            }
-            
-            // Extract and validate HW index
-            TString indexStr = fileName(hwPos+4, setPos-(hwPos+4));
-            bool isNumber = true;
-            for (int i = 0; i < indexStr.Length(); i++) {
-                if (!isdigit(indexStr[i])) {
-                    isNumber = false;
-                    break;
-                }
-            }
-            
-            if (!isNumber) {
-                std::cerr << "Error: Invalid HW index in electron file: " << fileName << std::endl;
-                result.invalidFiles.push_back(fileName.Data());
-                result.flags |= FLAG_DATA_INVALID;
-                continue;
-            }
-            
-            int hwIndex = atoi(indexStr.Data());
-            // Validate HW index range (0-7)
-            if (hwIndex < 0 || hwIndex > 7) {
-                std::cerr << "Error: HW index out of range (0-7) in electron file: " << fileName << std::endl;
-                result.invalidFiles.push_back(fileName.Data());
-                result.flags |= FLAG_DATA_INVALID;
-                continue;
-            }
-            
-            // Check for duplicate indices
-            if (foundElectronIndices.find(hwIndex) != foundElectronIndices.end()) {
-                std::cerr << "Error: Duplicate HW index " << hwIndex << " in electron files" << std::endl;
-                result.invalidFiles.push_back(fileName.Data());
-                result.flags |= FLAG_DATA_INVALID;
-                continue;
-            }
-            
-            // Record valid file
-            foundElectronIndices.insert(hwIndex);
-            result.electronCount++;
-            
-            // Check file accessibility and content
-            std::ifstream f_test(fullFilePath.Data());
-            if (!f_test.is_open()) {
-                std::cerr << "Error: Cannot open electron file: " << fullFilePath << std::endl;
-                result.openErrorFiles.push_back(fileName.Data());
-                result.flags |= FLAG_FILE_OPEN_TRIM;
-            } else {
-                // Quick empty file check
-                f_test.seekg(0, std::ios::end);
-                if (f_test.tellg() == 0) {
-                    result.emptyFiles.push_back(fileName.Data());
-                }
-                f_test.close();
-            }
-        }
-        // =================================================================
-        // HOLE FILE PROCESSING (similar to electron files)
-        // =================================================================}
-         else if (fileName.EndsWith("_holes.txt")) {
-            // Extract HW index from filename (format: *_HW_X_SET_*_hole.txt)
-            Ssiz_t hwPos = fileName.Index("_HW_");
-            Ssiz_t setPos = fileName.Index("_SET_", hwPos+4);
-            
-            if (hwPos == -1 || setPos == -1 || setPos <= hwPos+4) {
-                std::cerr << "Error: Invalid hole file name format: " << fileName << std::endl;
-                result.invalidFiles.push_back(fileName.Data());
-                result.flags |= FLAG_DATA_INVALID;
-                continue; // Skip malformed filenames
-            }
-            
-            // Extract and validate HW index
-            TString indexStr = fileName(hwPos+4, setPos-(hwPos+4));
-            bool isNumber = true;
-            for (int i = 0; i < indexStr.Length(); i++) {
-                if (!isdigit(indexStr[i])) {
-                    isNumber = false;
-                    break;
-                }
-            }
-            
-            if (!isNumber) {
-                std::cerr << "Error: Invalid HW index in hole file: " << fileName << std::endl;
-                result.invalidFiles.push_back(fileName.Data());
-                result.flags |= FLAG_DATA_INVALID;
-                continue;
-            }
-            
-            int hwIndex = atoi(indexStr.Data());
-            // Validate HW index range (0-7)
-            if (hwIndex < 0 || hwIndex > 7) {
-                std::cerr << "Error: HW index out of range (0-7) in hole file: " << fileName << std::endl;
-                result.invalidFiles.push_back(fileName.Data());
-                result.flags |= FLAG_DATA_INVALID;
-                continue;
-            }
-            
-            // Check for duplicate indices
-            if (foundHoleIndices.find(hwIndex) != foundHoleIndices.end()) {
-                std::cerr << "Error: Duplicate HW index " << hwIndex << " in hole files" << std::endl;
-                result.invalidFiles.push_back(fileName.Data());
-                result.flags |= FLAG_DATA_INVALID;
-                continue;
-            }
-            
-            // Record valid file
-            foundHoleIndices.insert(hwIndex);
-            result.holeCount++;
-            
-            // Check file accessibility and content
-            std::ifstream f_test(fullFilePath.Data());
-            if (!f_test.is_open()) {
-                std::cerr << "Error: Cannot open hole file: " << fullFilePath << std::endl;
-                result.openErrorFiles.push_back(fileName.Data());
-                result.flags |= FLAG_FILE_OPEN_TRIM;
-            } else {
-                // Quick empty file check
-                f_test.seekg(0, std::ios::end);
-                if (f_test.tellg() == 0) {
-                    result.emptyFiles.push_back(fileName.Data());
-                }
-                f_test.close();
-            }
-        }
-        // =================================================================
-        // UNEXPECTED FILE HANDLING
-        // =================================================================
-        else {
-            std::cerr << "Warning: Unexpected file in trim_files: " << fullFilePath << std::endl;
-            result.unexpectedFiles.push_back(fileName.Data());
-            result.flags |= FLAG_UNEXPECTED_FILES_TRIM;
-        }
-    }
-
-    delete files; // Clean up directory listing
-
-    // ===================================================================
-    // FINAL COUNT VALIDATION
-    // ===================================================================
-    /* Verify we have exactly 8 files for each type with unique indices */
-    if (result.electronCount != 8) {
-        std::cerr << "Error: Incorrect number of electron files: " << result.electronCount << "/8" << std::endl;
-        result.flags |= FLAG_ELECTRON_COUNT_TRIM;
-    } else if (foundElectronIndices.size() != 8) {
-        std::cerr << "Error: Missing or duplicate HW indices in electron files" << std::endl;
-        result.flags |= FLAG_ELECTRON_COUNT_TRIM;
-    }
-    
-    if (result.holeCount != 8) {
-        std::cerr << "Error: Incorrect number of hole files: " << result.holeCount << "/8" << std::endl;
-        result.flags |= FLAG_HOLE_COUNT_TRIM;
-    } else if (foundHoleIndices.size() != 8) {
-        std::cerr << "Error: Missing or duplicate HW indices in hole files" << std::endl;
-        result.flags |= FLAG_HOLE_COUNT_TRIM;
-    }
-
-    // Generate detailed report
-    std::cout << "\n===== Trim Files Status =====" << std::endl;
-    std::cout << "Electron files: " << result.electronCount << "/8 | "
-              << ((result.flags & FLAG_ELECTRON_COUNT_TRIM) ? "FAIL" : "OK")
-              << (result.electronCount < 8 ? " (UNDER)" : (result.electronCount > 8 ? " (OVER)" : "")) << std::endl;
-    std::cout << "Hole files:     " << result.holeCount << "/8 | "
-              << ((result.flags & FLAG_HOLE_COUNT_TRIM) ? "FAIL" : "OK")
-              << (result.holeCount < 8 ? " (UNDER)" : (result.holeCount > 8 ? " (OVER)" : "")) << std::endl;
-    std::cout << "File name format: " << (result.invalidFiles.empty() ? "ALL VALID" : "ERRORS DETECTED") << std::endl;
-    std::cout << "File accessibility: " << (result.openErrorFiles.empty() ? "ALL OK" : "ERRORS") << std::endl;
-
-    if (!result.emptyFiles.empty()) {
-        std::cout << "\n===== Empty Files =====" << std::endl;
-        for (const auto& file : result.emptyFiles) {
-            std::cout << " - " << file << std::endl;
-        }
-    }
-
-    if (!result.invalidFiles.empty()) {
-        std::cout << "\n===== Invalid Files (Bad Name Format) =====" << std::endl;
-        for (const auto& file : result.invalidFiles) {
-            std::cout << " - " << file << std::endl;
-        }
-    }
-
-    if (!result.openErrorFiles.empty()) {
-        std::cout << "\n===== File Open Errors =====" << std::endl;
-        for (const auto& file : result.openErrorFiles) {
-            std::cout << " - " << file << std::endl;
-        }
-    }
-
-    if (!result.unexpectedFiles.empty()) {
-        std::cout << "\n===== Unexpected Files =====" << std::endl;
-        for (const auto& file : result.unexpectedFiles) {
-            std::cout << " - " << file << std::endl;
-        }
-    }
-
-    std::cout << "\nSummary: ";
-    if (result.flags == 0) {
-        std::cout << "ALL CHECKS PASSED";
-    } else {
-        if (result.flags & FLAG_TRIM_FOLDER_MISSING) std::cout << "[FOLDER MISSING] ";
-        if (result.flags & FLAG_DIR_ACCESS_TRIM) std::cout << "[DIR ACCESS ERROR] ";
-        if (result.flags & FLAG_ELECTRON_COUNT_TRIM) std::cout << "[ELECTRON COUNT] ";
-        if (result.flags & FLAG_HOLE_COUNT_TRIM) std::cout << "[HOLE COUNT] ";
-        if (result.flags & FLAG_FILE_OPEN_TRIM) std::cout << "[FILE OPEN ERROR] ";
-        if (result.flags & FLAG_DATA_INVALID) std::cout << "[INVALID FILENAME] ";
-        if (result.flags & FLAG_UNEXPECTED_FILES_TRIM) std::cout << "[UNEXPECTED FILES]";
-    }
-    std::cout << std::endl;
-
-    return result;
-}
-
-/*
- * CheckPscanFiles:
- * Validates the parameter scan (pscan) files in the 'pscan_files' subdirectory.
- * This includes checking for required module files and per-HW electron/hole files.
- * 
- * Parameters:
- *   targetDir - Parent directory containing pscan_files
- * 
- * Returns:
- *   ValidationResult with pscan file findings
- * 
- * Checks:
- * 1. pscan_files subdirectory existence
- * 2. Module test files (root/txt/pdf)
- * 3. Exactly 8 electron text files (*_elect.txt)
- * 4. Exactly 8 hole text files (*_holes.txt) 
- * 5. Exactly 8 electron root files (*_elect.root)
- * 6. Exactly 8 hole root files (*_holes.root)
- * 7. File accessibility and validity
- * 8. No unexpected files in directory
- */
-ValidationResult CheckPscanFiles(const char* targetDir) {
-    ValidationResult result;
-    TString currentDir = gSystem->pwd();
-    TString pscanDirPath = TString::Format("%s/%s/pscan_files", currentDir.Data(), targetDir);
-
-    // PRIMARY CHECK: Verify existence of the required 'pscan_files' subdirectory */
-    if (gSystem->AccessPathName(pscanDirPath, kFileExists)) {
-        std::cerr << "\n===== CRITICAL ERROR =====" << std::endl;
-        std::cerr << "Directory 'pscan_files' does not exist!" << std::endl;
-        std::cerr << "Expected path: " << pscanDirPath << std::endl;
-        result.flags |= FLAG_PSCAN_FOLDER_MISSING;
-        return result; // Cannot proceed without this directory
-    }
-
-    // ===================================================================
-    // MODULE TEST FILES VALIDATION
-    // ===================================================================
-    /* Check required module-level files:
-     * 1. module_test_<dir>.root - ROOT format results
-     * 2. module_test_<dir>.txt  - Text summary
-     * 3. module_test_<dir>.pdf  - Report PDF
-     */
-    TString moduleRoot = TString::Format("%s/module_test_%s.root", pscanDirPath.Data(), targetDir);
-    TString moduleTxt = TString::Format("%s/module_test_%s.txt", pscanDirPath.Data(), targetDir);
-    TString modulePdf = TString::Format("%s/module_test_%s.pdf", pscanDirPath.Data(), targetDir);
-
-    // Check module ROOT file
-    if (gSystem->AccessPathName(moduleRoot, kFileExists)) {
-        std::cerr << "Error: Module test root file does not exist: " << moduleRoot << std::endl;
-        result.moduleErrorFiles.push_back(gSystem->BaseName(moduleRoot.Data()));
-        result.flags |= FLAG_MODULE_ROOT;
-    } else {
-        // Verify ROOT file can be opened and is valid
-        TFile* f_root = TFile::Open(moduleRoot, "READ");
-        if (!f_root || f_root->IsZombie()) {
-            std::cerr << "Error: Cannot open module test root file: " << moduleRoot << std::endl;
-            result.moduleErrorFiles.push_back(gSystem->BaseName(moduleRoot.Data()));
-            result.flags |= FLAG_MODULE_ROOT;
-        }
-        if (f_root) f_root->Close();
-    }
-
-    // Check module TXT file
-    if (gSystem->AccessPathName(moduleTxt, kFileExists)) {
-        std::cerr << "Error: Module test txt file does not exist: " << moduleTxt << std::endl;
-        result.moduleErrorFiles.push_back(gSystem->BaseName(moduleTxt.Data()));
-        result.flags |= FLAG_MODULE_TXT;
-    } else {
-        std::ifstream f_txt(moduleTxt.Data());
-        if (!f_txt.is_open()) {
-            std::cerr << "Error: Cannot open module test txt file: " << moduleTxt << std::endl;
-            result.moduleErrorFiles.push_back(gSystem->BaseName(moduleTxt.Data()));
-            result.flags |= FLAG_MODULE_TXT;
-        } else {
-            // Check if file is empty
-            f_txt.seekg(0, std::ios::end);
-            if (f_txt.tellg() == 0) {
-                result.emptyFiles.push_back(gSystem->BaseName(moduleTxt.Data()));
-            }
-            f_txt.close();
-        }
-    }
-
-    // Check module PDF file (existence only)
-    if (gSystem->AccessPathName(modulePdf, kFileExists)) {
-        std::cerr << "Error: Module test pdf file does not exist: " << modulePdf << std::endl;
-        result.moduleErrorFiles.push_back(gSystem->BaseName(modulePdf.Data()));
-        result.flags |= FLAG_MODULE_PDF;
-    }
-
-    // ===================================================================
-    // PER-HW FILES VALIDATION
-    // ===================================================================
-    TList* files = GetDirectoryListing(pscanDirPath);
-    if (!files) {
-        std::cerr << "Error: Could not read directory contents: " << pscanDirPath << std::endl;
-        result.flags |= FLAG_DIR_ACCESS_PSCAN;
-        return result;
-    }
-
-    // List of acceptable auxiliary files that aren't per-HW files
-    std::vector<std::string> acceptableAuxFiles = {
-        "module_test_SETUP.root",
-        "module_test_SETUP.txt",
-        "module_test_SETUP.pdf"
-    };
-
-    TSystemFile* file;
-    TIter next(files);
-    while ((file = (TSystemFile*)next())) {
-        TString fileName = file->GetName();
-        if (file->IsDirectory() || fileName == "." || fileName == "..") continue;
-        
-        TString fullFilePath = pscanDirPath + "/" + fileName;
-        bool isExpected = false;
-
-        // =================================================================
-        // ELECTRON TEXT FILES PROCESSING
-        // =================================================================
-        if (fileName.EndsWith("_elect.txt")) {
-            result.electronTxtCount++;
-            isExpected = true;
-
-            // Check file accessibility and content
-            std::ifstream f_test(fullFilePath.Data());
-            if (!f_test.is_open()) {
-                std::cerr << "Error: Cannot open electron txt file: " << fullFilePath << std::endl;
-                result.openErrorFiles.push_back(fileName.Data());
-                result.flags |= FLAG_FILE_OPEN_PSCAN;
-            } else {
-                // Check if file is empty
-                f_test.seekg(0, std::ios::end);
-                if (f_test.tellg() == 0) {
-                    result.emptyFiles.push_back(fileName.Data());
-                }
-                f_test.close();
-            }
-        }
-
-        // =================================================================
-        // HOLE TEXT FILES PROCESSING
-        // =================================================================
-        else if (fileName.EndsWith("_holes.txt")) {
-            result.holeTxtCount++;
-            isExpected = true;
-
-            // Check file accessibility and content
-            std::ifstream f_test(fullFilePath.Data());
-            if (!f_test.is_open()) {
-                std::cerr << "Error: Cannot open hole txt file: " << fullFilePath << std::endl;
-                result.openErrorFiles.push_back(fileName.Data());
-                result.flags |= FLAG_FILE_OPEN_PSCAN;
-            } else {
-                // Check if file is empty
-                f_test.seekg(0, std::ios::end);
-                if (f_test.tellg() == 0) {
-                    result.emptyFiles.push_back(fileName.Data());
-                }
-                f_test.close();
-            }
-        }
-
-        // =================================================================
-        // ELECTRON ROOT FILES PROCESSING
-        // =================================================================
-        else if (fileName.EndsWith("_elect.root")) {
-            result.electronRootCount++;
-            isExpected = true;
-
-            // Validate ROOT file can be opened
-            TFile* rootFile = TFile::Open(fullFilePath, "READ");
-            if (!rootFile || rootFile->IsZombie()) {
-                std::cerr << "Error: Cannot open electron root file: " << fullFilePath << std::endl;
-                result.openErrorFiles.push_back(fileName.Data());
-                result.flags |= FLAG_FILE_OPEN_PSCAN;
-            }
-            if (rootFile) rootFile->Close();
-        }
-        
-        // =================================================================
-        // HOLE ROOT FILES PROCESSING
-        // =================================================================
-        else if (fileName.EndsWith("_holes.root")) {
-            result.holeRootCount++;
-            isExpected = true;
-
-            // Validate ROOT file can be opened
-            TFile* rootFile = TFile::Open(fullFilePath, "READ");
-            if (!rootFile || rootFile->IsZombie()) {
-                std::cerr << "Error: Cannot open hole root file: " << fullFilePath << std::endl;
-                result.openErrorFiles.push_back(fileName.Data());
-                result.flags |= FLAG_FILE_OPEN_PSCAN;
-            }
-            if (rootFile) rootFile->Close();
-        }
-
-        // =================================================================
-        // MODULE/ACCEPTABLE AUX FILES CHECK
-        // =================================================================
-        else {
-            // Check if it's a module file or acceptable aux file
-            TString modulePrefix = TString::Format("module_test_%s", targetDir);
-            if (fileName.BeginsWith(modulePrefix) && 
-                (fileName.EndsWith(".root") || fileName.EndsWith(".txt") || fileName.EndsWith(".pdf"))) {
-                isExpected = true;
-            } else {
-                // Check against acceptable auxiliary files
-                for (const auto& auxFile : acceptableAuxFiles) {
-                    if (fileName == auxFile) {
-                        isExpected = true;
-                        break;
-                    }
-                }
-            }
-        }
-
-        // =================================================================
-        // UNEXPECTED FILES HANDLING
-        // =================================================================
-        if (!isExpected) {
-            std::cerr << "Warning: Unexpected file in pscan_files: " << fullFilePath << std::endl;
-            result.unexpectedFiles.push_back(fileName.Data());
-            result.flags |= FLAG_UNEXPECTED_FILES_PSCAN;
-        }
-    }
-
-    delete files; // Clean up directory listing
-
-    // ===================================================================
-    // FINAL COUNT VALIDATION
-    // ===================================================================
-    /* Verify we have exactly 8 files of each required type */
-    if (result.electronTxtCount != 8) {
-        std::cerr << "Error: Incorrect number of electron txt files: " << result.electronTxtCount << "/8" << std::endl;
-        result.flags |= FLAG_ELECTRON_TXT;
-    }
-    if (result.holeTxtCount != 8) {
-        std::cerr << "Error: Incorrect number of hole txt files: " << result.holeTxtCount << "/8" << std::endl;
-        result.flags |= FLAG_HOLE_TXT;
-    }
-    if (result.electronRootCount != 8) {
-        std::cerr << "Error: Incorrect number of electron root files: " << result.electronRootCount << "/8" << std::endl;
-        result.flags |= FLAG_ELECTRON_ROOT;
-    }
-    if (result.holeRootCount != 8) {
-        std::cerr << "Error: Incorrect number of hole root files: " << result.holeRootCount << "/8" << std::endl;
-        result.flags |= FLAG_HOLE_ROOT;
-    }
-
-    // Generate detailed report
-    std::cout << "\n===== Pscan Files Status =====" << std::endl;
-    std::cout << "Electron text files: " << result.electronTxtCount << "/8 | "
-              << ((result.flags & FLAG_ELECTRON_TXT) ? "FAIL" : "OK") 
-              << (result.electronTxtCount < 8 ? " (UNDER)" : (result.electronTxtCount > 8 ? " (OVER)" : "")) << std::endl;
-    std::cout << "Hole text files:     " << result.holeTxtCount << "/8 | "
-              << ((result.flags & FLAG_HOLE_TXT) ? "FAIL" : "OK")
-              << (result.holeTxtCount < 8 ? " (UNDER)" : (result.holeTxtCount > 8 ? " (OVER)" : "")) << std::endl;
-    std::cout << "Electron ROOT files: " << result.electronRootCount << "/8 | "
-              << ((result.flags & FLAG_ELECTRON_ROOT) ? "FAIL" : "OK")
-              << (result.electronRootCount < 8 ? " (UNDER)" : (result.electronRootCount > 8 ? " (OVER)" : "")) << std::endl;
-    std::cout << "Hole ROOT files:     " << result.holeRootCount << "/8 | "
-              << ((result.flags & FLAG_HOLE_ROOT) ? "FAIL" : "OK")
-              << (result.holeRootCount < 8 ? " (UNDER)" : (result.holeRootCount > 8 ? " (OVER)" : "")) << std::endl;
-    std::cout << "Module test root:  " << (result.flags & FLAG_MODULE_ROOT ? "ERROR" : "OK") << std::endl;
-    std::cout << "Module test txt:   " << (result.flags & FLAG_MODULE_TXT ? "ERROR" : "OK") << std::endl;
-    std::cout << "Module test pdf:   " << (result.flags & FLAG_MODULE_PDF ? "MISSING" : "OK") << std::endl;
-    std::cout << "File accessibility:    " << (result.openErrorFiles.empty() ? "ALL OK" : "ERRORS DETECTED") << std::endl;
-
-    if (!result.emptyFiles.empty()) {
-        std::cout << "\n===== Empty Files =====" << std::endl;
-        for (const auto& file : result.emptyFiles) {
-            std::cout << " - " << file << std::endl;
-        }
-    }
-
-    if (!result.moduleErrorFiles.empty()) {
-        std::cout << "\n===== Module Test Errors =====" << std::endl;
-        for (const auto& file : result.moduleErrorFiles) {
-            std::cout << " - " << file << std::endl;
-        }
-    }
-
-    if (!result.openErrorFiles.empty()) {
-        std::cout << "\n===== File Open Errors =====" << std::endl;
-        for (const auto& file : result.openErrorFiles) {
-            std::cout << " - " << file << std::endl;
-        }
-    }
-
-    if (!result.unexpectedFiles.empty()) {
-        std::cout << "\n===== Unexpected Files =====" << std::endl;
-        for (const auto& file : result.unexpectedFiles) {
-            std::cout << " - " << file << std::endl;
-        }
-    }
-
-    std::cout << "\nSummary: ";
-    if (result.flags == 0) {
-        std::cout << "ALL CHECKS PASSED";
-    } else {
-        if (result.flags & FLAG_PSCAN_FOLDER_MISSING) std::cout << "[FOLDER MISSING] ";
-        if (result.flags & FLAG_DIR_ACCESS_PSCAN) std::cout << "[DIR ACCESS ERROR] ";
-        if (result.flags & FLAG_ELECTRON_TXT) std::cout << "[ELECTRON TXT COUNT] ";
-        if (result.flags & FLAG_HOLE_TXT) std::cout << "[HOLE TXT COUNT] ";
-        if (result.flags & FLAG_ELECTRON_ROOT) std::cout << "[ELECTRON ROOT COUNT] ";
-        if (result.flags & FLAG_HOLE_ROOT) std::cout << "[HOLE ROOT COUNT] ";
-        if (result.flags & FLAG_FILE_OPEN_PSCAN) std::cout << "[FILE OPEN ERROR] ";
-        if (result.flags & FLAG_MODULE_ROOT) std::cout << "[MODULE ROOT ERROR] ";
-        if (result.flags & FLAG_MODULE_TXT) std::cout << "[MODULE TXT ERROR] ";
-        if (result.flags & FLAG_MODULE_PDF) std::cout << "[MODULE PDF MISSING] ";
-        if (result.flags & FLAG_UNEXPECTED_FILES_PSCAN) std::cout << "[UNEXPECTED FILES]";
-    }
-    std::cout << std::endl;
-
-    return result;
-}
-
-/*
- * CheckConnFiles:
- * Validates connection test files in the 'conn_check_files' subdirectory.
- * Ensures proper count and accessibility of electron and hole connection files.
- * 
- * Parameters:
- *   targetDir - Parent directory containing conn_check_files
- * 
- * Returns:
- *   ValidationResult with connection file findings
- * 
- * Checks:
- * 1. conn_check_files subdirectory existence
- * 2. Exactly 8 electron files (*_elect.txt)
- * 3. Exactly 8 hole files (*_holes.txt)
- * 4. File accessibility
- * 5. No unexpected files in directory
- */
-ValidationResult CheckConnFiles(const char* targetDir) {
-    ValidationResult result;
-    TString currentDir = gSystem->pwd();
-    TString fullTargetPath = TString::Format("%s/%s", currentDir.Data(), targetDir);
-    TString connDirPath = TString::Format("%s/%s/conn_check_files", currentDir.Data(), targetDir);
-
-    // PRIMARY CHECK: Verify existence of the required 'conn_check_files' subdirectory */
-    if (gSystem->AccessPathName(connDirPath, kFileExists)) {
-        std::cerr << "\n===== CRITICAL ERROR =====" << std::endl;
-        std::cerr << "Directory 'conn_check_files' does not exist!" << std::endl;
-        std::cerr << "Target folder: " << fullTargetPath << std::endl;
-        std::cerr << "Expected path: " << connDirPath << std::endl;
-        result.flags |= FLAG_CONN_FOLDER_MISSING;
-        return result; // Cannot proceed without this directory
-    }
-
-    // ===================================================================
-    // DIRECTORY SCANNING INITIALIZATION
-    // ===================================================================
-    TList* files = GetDirectoryListing(connDirPath);
-    if (!files) {
-        std::cerr << "Error: Could not read directory contents: " << connDirPath << std::endl;
-        result.flags |= FLAG_DIR_ACCESS;
-        return result;
-    }
-
-    // ===================================================================
-    // FILE PROCESSING LOOP
-    // ===================================================================
-    TSystemFile* file;
-    TIter next(files);
-    while ((file = (TSystemFile*)next())) {
-        TString fileName = file->GetName();
-
-        // Skip directories and special files
-        if (file->IsDirectory() || fileName == "." || fileName == "..") continue;
-        
-        TString fullFilePath = connDirPath + "/" + fileName;
-
-        // =================================================================
-        // ELECTRON FILE PROCESSING
-        // =================================================================
-        if (fileName.EndsWith("_elect.txt")) {
-            result.electronCount++;
-
-            // Check file accessibility
-            std::ifstream f_test(fullFilePath.Data());
-            if (!f_test.is_open()) {
-                std::cerr << "Error: Cannot open electron file: " << fullFilePath << std::endl;
-                result.openErrorFiles.push_back(fileName.Data());
-                result.flags |= FLAG_FILE_OPEN_CONN;
-            } else {
-                // Check if file is empty
-                f_test.seekg(0, std::ios::end);
-                if (f_test.tellg() == 0) {
-                    result.emptyFiles.push_back(fileName.Data());
-                }
-                f_test.close();
-            }
-        }
-
-        // =================================================================
-        // HOLE FILE PROCESSING
-        // =================================================================
-        else if (fileName.EndsWith("_holes.txt")) {
-            result.holeCount++;
-
-            // Check file accessibility
-            std::ifstream f_test(fullFilePath.Data());
-            if (!f_test.is_open()) {
-                std::cerr << "Error: Cannot open hole file: " << fullFilePath << std::endl;
-                result.openErrorFiles.push_back(fileName.Data());
-                result.flags |= FLAG_FILE_OPEN_CONN;
-            } else {
-                // Check if file is empty
-                f_test.seekg(0, std::ios::end);
-                if (f_test.tellg() == 0) {
-                    result.emptyFiles.push_back(fileName.Data());
-                }
-                f_test.close();
-            }
-        }
-
-        // =================================================================
-        // UNEXPECTED FILE HANDLING
-        // =================================================================
-        else {
-            std::cerr << "Warning: Unexpected file in conn_check_files: " << fullFilePath << std::endl;
-            result.unexpectedFiles.push_back(fileName.Data());
-            result.flags |= FLAG_UNEXPECTED_FILES_CONN;
-        }
-    }
-
-    delete files; // Clean up directory listing
-
-    // ===================================================================
-    // FINAL COUNT VALIDATION
-    // ===================================================================
-    /* Verify we have exactly 8 files for each type */
-    if (result.electronCount != 8) {
-        std::cerr << "Error: Incorrect number of electron files: " << result.electronCount << "/8" << std::endl;
-        result.flags |= FLAG_ELECTRON_COUNT;
-    }
-    if (result.holeCount != 8) {
-        std::cerr << "Error: Incorrect number of hole files: " << result.holeCount << "/8" << std::endl;
-        result.flags |= FLAG_HOLE_COUNT;
-    }
-
-    // Generate detailed report
-    std::cout << "\n===== Connection Files Status =====" << std::endl;
-    std::cout << "Electron files: " << result.electronCount << "/8 | "
-              << ((result.flags & FLAG_ELECTRON_COUNT) ? "FAIL" : "OK") 
-              << (result.electronCount < 8 ? " (UNDER)" : (result.electronCount > 8 ? " (OVER)" : "")) << std::endl;
-    std::cout << "Hole files:     " << result.holeCount << "/8 | "
-              << ((result.flags & FLAG_HOLE_COUNT) ? "FAIL" : "OK")
-              << (result.holeCount < 8 ? " (UNDER)" : (result.holeCount > 8 ? " (OVER)" : "")) << std::endl;
-    std::cout << "File accessibility: " << (result.openErrorFiles.empty() ? "ALL OK" : "ERRORS DETECTED") << std::endl;
-
-    if (!result.emptyFiles.empty()) {
-        std::cout << "\n===== Empty Files =====" << std::endl;
-        for (const auto& file : result.emptyFiles) {
-            std::cout << " - " << file << std::endl;
-        }
-    }
-
-    if (!result.openErrorFiles.empty()) {
-        std::cout << "\n===== File Open Errors =====" << std::endl;
-        for (const auto& file : result.openErrorFiles) {
-            std::cout << " - " << file << std::endl;
-        }
-    }
-
-    if (!result.unexpectedFiles.empty()) {
-        std::cout << "\n===== Unexpected Files =====" << std::endl;
-        for (const auto& file : result.unexpectedFiles) {
-            std::cout << " - " << file << std::endl;
-        }
-    }
-
-    std::cout << "\nSummary: ";
-    if (result.flags == 0) {
-        std::cout << "ALL CHECKS PASSED";
-    } else {
-        if (result.flags & FLAG_CONN_FOLDER_MISSING) std::cout << "[FOLDER MISSING] ";
-        if (result.flags & FLAG_DIR_ACCESS) std::cout << "[DIR ACCESS ERROR] ";
-        if (result.flags & FLAG_ELECTRON_COUNT) std::cout << "[ELECTRON COUNT] ";
-        if (result.flags & FLAG_HOLE_COUNT) std::cout << "[HOLE COUNT] ";
-        if (result.flags & FLAG_FILE_OPEN_CONN) std::cout << "[FILE OPEN ERROR] ";
-        if (result.flags & FLAG_UNEXPECTED_FILES_CONN) std::cout << "[UNEXPECTED FILES]";
-    }
-    std::cout << std::endl;
-
-    return result;
-}
-
-// ===================================================================
-// Reporting Functions
-// ===================================================================
-
-/*
- * GenerateReportPage:
- * Creates a detailed validation report for a single test directory by combining results
- * from all validation checks (log, trim, pscan, and connection files).
- * 
- * Parameters:
- *   dirName - Name of the directory being validated
- * 
- * Effects:
- * - Runs all four validation functions
- * - Determines overall directory status
- * - Updates global counters
- * - Adds formatted report to gState.reportPages
- */
-void GenerateReportPage(const TString& dirName) {
-    std::stringstream report; // String stream to build the report
-    
-    // ===================================================================
-    // REPORT HEADER
-    // ===================================================================
-    report << "====================================================" << std::endl;
-    report << "VALIDATION REPORT FOR: " << dirName << std::endl;
-    report << "====================================================" << std::endl;
-    
-    // ===================================================================
-    // RUN ALL VALIDATIONS
-    // ===================================================================
-    /* Execute all four validation functions for this directory */
-    ValidationResult logResult = CheckLogFiles(dirName.Data());
-    ValidationResult trimResult = CheckTrimFiles(dirName.Data());
-    ValidationResult pscanResult = CheckPscanFiles(dirName.Data());
-    ValidationResult connResult = CheckConnFiles(dirName.Data());
-    
-    // ===================================================================
-    // DETERMINE OVERALL STATUS
-    // ===================================================================
-    /* Status hierarchy: DIRECTORY PROBLEM> INCONSISTENT DATA (MISSING/EXTRA) > INCONSISTENT DATA (AUXILIARY FILES) > CONSISTENT DATA */
-    int dirStatus = STATUS_DATA_CONSISTENT;
-    std::string statusStr = "DATA CONSISTENT ";
-    
-    // Check for directory problems first
-    if (logResult.flags & (FLAG_DIR_MISSING) ||
-        trimResult.flags & (FLAG_TRIM_FOLDER_MISSING | FLAG_DIR_ACCESS_TRIM) ||
-        pscanResult.flags & (FLAG_PSCAN_FOLDER_MISSING | FLAG_DIR_ACCESS_PSCAN) ||
-        connResult.flags & (FLAG_CONN_FOLDER_MISSING | FLAG_DIR_ACCESS)) {
-        dirStatus = STATUS_DIRECTORY_ERROR;
-        statusStr = "DIRECTORY ERROR";
-     }
-    //check for critical issues (missing/extra files)
-     else if (logResult.flags & (FLAG_LOG_MISSING | FLAG_DATA_MISSING | FLAG_NO_FEB_FILE | FLAG_FILE_OPEN | FLAG_DATA_INVALID | FLAG_DATA_EMPTY) ||
-        trimResult.flags & (FLAG_FILE_OPEN_TRIM | FLAG_ELECTRON_COUNT_TRIM | FLAG_HOLE_COUNT_TRIM) ||
-        pscanResult.flags & (FLAG_FILE_OPEN_PSCAN | FLAG_ELECTRON_TXT | FLAG_HOLE_TXT | FLAG_ELECTRON_ROOT | FLAG_HOLE_ROOT | FLAG_MODULE_ROOT | FLAG_MODULE_TXT | FLAG_MODULE_PDF) ||
-        connResult.flags & (FLAG_FILE_OPEN_CONN | FLAG_ELECTRON_COUNT | FLAG_HOLE_COUNT)) {
-        dirStatus = STATUS_DATA_INCONSISTENT_MISSING_EXTRA;
-        statusStr = "DATA INCONSISTENT (MISSING/EXTRA)";
-    }
-    // Check for non-critical issues (unexpected files)
-    else if (logResult.flags & (FLAG_UNEXPECTED_FILES) ||
-             trimResult.flags & (FLAG_UNEXPECTED_FILES_TRIM) ||
-             pscanResult.flags & (FLAG_UNEXPECTED_FILES_PSCAN) ||
-             connResult.flags & (FLAG_UNEXPECTED_FILES_CONN)) {
-        dirStatus = STATUS_DATA_INCONSISTENT_AUXILIARY;
-        statusStr = "DATA INCONSISTENT (AUXILIARY FILES)";
-    }
-    
-    // ===================================================================
-    // UPDATE GLOBAL COUNTERS
-    // ===================================================================
-    switch (dirStatus) {
-        case STATUS_DATA_CONSISTENT:
-            gState.goodDirs++;
-            break;
-        case STATUS_DATA_INCONSISTENT_AUXILIARY:
-            gState.auxDirs++;
-            break;
-        case STATUS_DATA_INCONSISTENT_MISSING_EXTRA:
-            gState.missextraDirs++;
-            break;
-        case STATUS_DIRECTORY_ERROR:
-            gState.errorDirs++;
-            break;
-    }
-    
-    // ===================================================================
-    // REPORT GENERATION
-    // ===================================================================
-    
-    // 1. STATUS HEADER
-    report << "STATUS: " << statusStr << std::endl;
-    
-    // 2. LOG FILES SECTION
-    report << "\n[LOG FILES]" << std::endl;
-    report << "Data files: " << logResult.dataFileCount << " found | " 
-           << (logResult.flags & FLAG_DATA_MISSING ? "NONE" : 
-              (logResult.flags & FLAG_DATA_EMPTY) ? "SOME EMPTY" :
-              (logResult.flags & FLAG_DATA_INVALID) ? "SOME INVALID" : "VALID") << std::endl;
-    report << "Non-empty files: " << logResult.nonEmptyDataCount << "/" << logResult.dataFileCount << std::endl;
-    report << "Valid files: " << logResult.validDataCount << "/" << logResult.dataFileCount << std::endl;
-    report << "Tester FEB files: " << (logResult.foundFebFile ? "MATCHED" : "UNMATCHED") << std::endl;
-    report << "Log file: " << (logResult.logExists ? "FOUND" : "MISSING") << std::endl;
-    
-    // 2a. Empty log files
-    if (!logResult.emptyFiles.empty()) {
-        report << "\nEmpty log data files:" << std::endl;
-        for (const auto& file : logResult.emptyFiles) {
-            report << " - " << file << std::endl;
-        }
-    }
-    
-    // 2b. Invalid log files
-    if (!logResult.invalidFiles.empty()) {
-        report << "\nInvalid log data files:" << std::endl;
-        for (const auto& file : logResult.invalidFiles) {
-            report << " - " << file << std::endl;
-        }
-    }
-    
-    // 3. TRIM FILES SECTION
-    report << "\n[TRIM FILES]" << std::endl;
-    report << "Electron files: " << trimResult.electronCount << "/8" << std::endl;
-    report << "Hole files: " << trimResult.holeCount << "/8" << std::endl;
-    
-    // 3a. Empty trim files
-    if (!trimResult.emptyFiles.empty()) {
-        report << "\nEmpty trim files:" << std::endl;
-        for (const auto& file : trimResult.emptyFiles) {
-            report << " - " << file << std::endl;
-        }
-    }
-    
-    // 4. PSCAN FILES SECTION
-    report << "\n[PSCAN FILES]" << std::endl;
-    report << "Electron text: " << pscanResult.electronTxtCount << "/8" << std::endl;
-    report << "Hole text: " << pscanResult.holeTxtCount << "/8" << std::endl;
-    report << "Electron root: " << pscanResult.electronRootCount << "/8" << std::endl;
-    report << "Hole root: " << pscanResult.holeRootCount << "/8" << std::endl;
-    report << "Module files: " << (pscanResult.flags & (FLAG_MODULE_ROOT|FLAG_MODULE_TXT|FLAG_MODULE_PDF) ? "ERROR" : "OK") << std::endl;
-    
-    // 4a. Empty pscan files
-    if (!pscanResult.emptyFiles.empty()) {
-        report << "\nEmpty pscan files:" << std::endl;
-        for (const auto& file : pscanResult.emptyFiles) {
-            report << " - " << file << std::endl;
-        }
-    }
-    
-    // 4b. Module file errors
-    if (!pscanResult.moduleErrorFiles.empty()) {
-        report << "\nModule test file errors:" << std::endl;
-        for (const auto& file : pscanResult.moduleErrorFiles) {
-            report << " - " << file << std::endl;
-        }
-    }
-    
-    // 5. CONNECTION FILES SECTION
-    report << "\n[CONNECTION FILES]" << std::endl;
-    report << "Electron files: " << connResult.electronCount << "/8" << std::endl;
-    report << "Hole files: " << connResult.holeCount << "/8" << std::endl;
-    
-    if (!connResult.emptyFiles.empty()) {
-        report << "\nEmpty connection files:" << std::endl;
-        for (const auto& file : connResult.emptyFiles) {
-            report << " - " << file << std::endl;
-        }
-    }
-    
-    // ===================================================================
-    // ERROR SUMMARY SECTION
-    // ===================================================================
-    
-    // 6. FILE OPEN ERRORS (combined from all validations)
-    if (!logResult.openErrorFiles.empty() || !trimResult.openErrorFiles.empty() ||
-        !pscanResult.openErrorFiles.empty() || !connResult.openErrorFiles.empty()) {
-        report << "\n[FILE OPEN ERRORS]" << std::endl;
-        
-        if (!logResult.openErrorFiles.empty()) {
-            report << "Log file errors:" << std::endl;
-            for (const auto& file : logResult.openErrorFiles) report << "  - " << file << std::endl;
-        }
-        if (!trimResult.openErrorFiles.empty()) {
-            report << "Trim file errors:" << std::endl;
-            for (const auto& file : trimResult.openErrorFiles) report << "  - " << file << std::endl;
-        }
-        if (!pscanResult.openErrorFiles.empty()) {
-            report << "Pscan file errors:" << std::endl;
-            for (const auto& file : pscanResult.openErrorFiles) report << "  - " << file << std::endl;
-        }
-        if (!connResult.openErrorFiles.empty()) {
-            report << "Connection file errors:" << std::endl;
-            for (const auto& file : connResult.openErrorFiles) report << "  - " << file << std::endl;
-        }
-    }
-    
-    // 7. UNEXPECTED FILES (combined from all validations)
-    if (!logResult.unexpectedFiles.empty() || !trimResult.unexpectedFiles.empty() ||
-        !pscanResult.unexpectedFiles.empty() || !connResult.unexpectedFiles.empty()) {
-        report << "\n[UNEXPECTED FILES]" << std::endl;
-        
-        if (!logResult.unexpectedFiles.empty()) {
-            report << "Log directory unexpected files:" << std::endl;
-            for (const auto& file : logResult.unexpectedFiles) report << "  - " << file << std::endl;
-        }
-        if (!trimResult.unexpectedFiles.empty()) {
-            report << "Trim directory unexpected files:" << std::endl;
-            for (const auto& file : trimResult.unexpectedFiles) report << "  - " << file << std::endl;
-        }
-        if (!pscanResult.unexpectedFiles.empty()) {
-            report << "Pscan directory unexpected files:" << std::endl;
-            for (const auto& file : pscanResult.unexpectedFiles) report << "  - " << file << std::endl;
-        }
-        if (!connResult.unexpectedFiles.empty()) {
-            report << "Connection directory unexpected files:" << std::endl;
-            for (const auto& file : connResult.unexpectedFiles) report << "  - " << file << std::endl;
-        }
-    }
-    
-    // ===================================================================
-    // STORE FINAL REPORT
-    // ===================================================================
-    gState.reportPages.push_back(report.str());
-}
-
-/*
- * SaveTxtReport:
- * Generates and saves a complete text report containing all validation results
- * to a specified file. Includes both individual directory reports and global summary.
- *
- * Parameters:
- *   filename - Full path of the output text file to create/overwrite
- *
- * Operation:
- * 1. Creates/overwrites the specified text file
- * 2. Writes a standardized report header with metadata
- * 3. Outputs all individual directory reports
- * 4. Appends the global summary statistics
- * 5. Closes the file with proper error handling
- *
- * Output Format:
- * - Plain ASCII text with clear section headers
- * - Fixed-width formatting for alignment
- * - Human-readable status indicators
- */
-void SaveTxtReport(const TString& filename) {
-    // Attempt to open the output file
-    std::ofstream out(filename.Data());
-    
-    // ===================================================================
-    // FILE OPENING VALIDATION
-    // ===================================================================
-    if (!out.is_open()) {
-        std::cerr << "Error: Could not open report file for writing: " << filename << std::endl;
-        return;
-    }
-
-    // ===================================================================
-    // REPORT HEADER SECTION
-    // ===================================================================
-    /* Standardized header with metadata */
-    out << "=======================================================\n";
-    out << "      EXORCISM VALIDATION REPORT - TEXT VERSION\n";
-    out << "=======================================================\n\n";
-    
-    // System and timing information
-    out << "Ladder: " << gState.currentLadder << "\n";
-    out << "Report generated: " << __DATE__ << " " << __TIME__ << "\n";
-    out << "Total directories processed: " 
-        << (gState.goodDirs + gState.auxDirs + gState.missextraDirs+gState.errorDirs) << "\n";
-    out << "-------------------------------------------------------\n\n";
-
-    // ===================================================================
-    // INDIVIDUAL DIRECTORY REPORTS
-    // ===================================================================
-    /* Write each directory's report in sequence */
-    for (size_t i = 0; i < gState.reportPages.size(); i++) {
-        // Add separator between reports
-        if (i > 0) {
-            out << "\n\n";
-            out << "=======================================================\n";
-            out << "              NEXT DIRECTORY REPORT\n";
-            out << "=======================================================\n\n";
-        }
-        
-        // Write the actual report content
-        out << gState.reportPages[i];
-    }
-
-    // ===================================================================
-    // GLOBAL SUMMARY SECTION
-    // ===================================================================
-    /* Final consolidated statistics */
-    out << "\n\n";
-    out << "=======================================================\n";
-    out << "                 VALIDATION SUMMARY\n";
-    out << "=======================================================\n\n";
-    
-    // Calculate success rate (handling division by zero)
-    int totalDirs = gState.goodDirs + gState.auxDirs + gState.missextraDirs+gState.errorDirs;
-    float successRate = (totalDirs > 0) ? 
-        (100.0f * (gState.goodDirs + gState.auxDirs) / totalDirs) : 0.0f;
-
-    // Summary statistics
-    out << "Directories with consistent data: " << gState.goodDirs << "\n";
-    out << "Directories with inconsistent data (auxiliary files found): " << gState.auxDirs << "\n";
-    out << "Directories with inconsistent data (missing/extra files): " << gState.missextraDirs << "\n";
-    out << "Directories with access errors: " << gState.errorDirs << "\n";
-    out << "Overall success rate: " << std::fixed << std::setprecision(1) 
-        << successRate << "%\n\n";
-    
-    // Add any additional global summary content
-    if (!gState.globalSummary.empty()) {
-        out << gState.globalSummary << "\n";
-    }
-
-    // ===================================================================
-    // REPORT FOOTER
-    // ===================================================================
-    out << "=======================================================\n";
-    out << "                 END OF REPORT\n";
-    out << "=======================================================\n";
-
-    // ===================================================================
-    // FILE CLOSING AND CONFIRMATION
-    // ===================================================================
-    out.close();
-    
-    // Verify successful write operation
-    if (out.fail()) {
-        std::cerr << "Warning: Potential write error during report generation: " 
-                  << filename << std::endl;
-    } else {
-        std::cout << "Text report successfully saved to: " << filename << std::endl;
-    }
-}
-
-/*
- * SaveRootReport:
- * Saves all validation reports to a ROOT file format for programmatic analysis.
- * Stores each directory report as a separate TObjString and includes summary statistics.
- *
- * Parameters:
- *   filename - Full path of the output ROOT file to create/overwrite
- *
- * Operation:
- * 1. Creates a new ROOT file (overwrites existing)
- * 2. Saves each directory report as a named TObjString
- * 3. Stores global summary as a separate object
- * 4. Ensures proper file closure and error handling
- *
- * ROOT File Structure:
- * - Contains TObjString objects for each directory report
- * - Includes "GlobalSummary" TObjString
- * - Objects named systematically (Directory_0, Directory_1, etc.)
- */
-void SaveRootReport(const TString& filename) {
-    // ===================================================================
-    // FILE CREATION AND VALIDATION
-    // ===================================================================
-    /* Create the ROOT file (RECREATE mode overwrites existing) */
-    TFile file(filename, "RECREATE");
-    
-    // Verify file was created successfully
-    if (file.IsZombie()) {
-        std::cerr << "Error: Could not create ROOT report file: " << filename << std::endl;
-        return;
-    }
-
-    // ===================================================================
-    // STORE INDIVIDUAL DIRECTORY REPORTS
-    // ===================================================================
-    /* Save each directory report as a separate named object */
-    for (size_t i = 0; i < gState.reportPages.size(); i++) {
-        // Create object name with index (Directory_0, Directory_1, etc.)
-        TString name = TString::Format("Directory_%zu", i);
-        
-        // Create a ROOT string object containing the report
-        TObjString obj(gState.reportPages[i].c_str());
-        
-        // Write to file and check for errors
-        if (obj.Write(name) == 0) {
-            std::cerr << "Warning: Failed to write directory report " << i 
-                      << " to ROOT file" << std::endl;
-        }
-    }
-
-    // ===================================================================
-    // STORE GLOBAL SUMMARY
-    // ===================================================================
-    /* Save the consolidated summary as a special object */
-    TObjString summary(gState.globalSummary.c_str());
-    if (summary.Write("GlobalSummary") == 0) {
-        std::cerr << "Warning: Failed to write global summary to ROOT file" << std::endl;
-    }
-
-    // ===================================================================
-    // FILE FINALIZATION
-    // ===================================================================
-    /* Properly close the file and handle any errors */
-    file.Close();
-    
-    // Verify write operation was successful
-    if (file.TestBit(TFile::kWriteError)) {
-        std::cerr << "Warning: Potential write error during ROOT file creation: " 
-                  << filename << std::endl;
-    } else {
-        std::cout << "ROOT report successfully saved to: " << filename << std::endl;
-        
-        // Optional: Print file size for verification
-        Long64_t size = file.GetSize();
-        std::cout << "File size: " << size << " bytes" << std::endl;
-    }
-}
-
-/*
- * SavePdfReport:
- * Generates a comprehensive PDF report with graphical elements including:
- * - Summary page with pie chart visualization
- * - Detailed directory reports with color-coded status
- * - Professional formatting and visual hierarchy
- *
- * Parameters:
- *   filename - Full path of the output PDF file
- *
- * Operation:
- * 1. Creates a multi-page PDF document using ROOT's TCanvas
- * 2. First page shows global statistics and pie chart
- * 3. Subsequent pages show individual directory reports
- * 4. Uses color coding to highlight status and issues
- * 5. Closes PDF document properly
- */
-void SavePdfReport(const TString& filename) {
-    // Create a canvas for PDF output (1200x1600 pixels)
-    TCanvas canvas("canvas", "Validation Report", 1200, 1600);
-
-    // ===================================================================
-    // PDF DOCUMENT INITIALIZATION
-    // ===================================================================
-    /* Open PDF document - use [ to start multi-page document */
-    canvas.Print(filename + "[");
-    
-    // ===================================================================
-    // PAGE 1: GLOBAL SUMMARY
-    // ===================================================================
-    canvas.Clear();
-    canvas.Divide(1, 2); // Split canvas into top and bottom sections
-    
-    // -------------------------------------------------------------------
-    // TOP SECTION: TEXT SUMMARY
-    // -------------------------------------------------------------------
-    canvas.cd(1); // Activate top section
-    
-    // Create text box for summary information
-    TPaveText summaryBox(0.05, 0.05, 0.95, 0.95);
-    summaryBox.AddText("EXORCISM VALIDATION REPORT - GLOBAL SUMMARY");
-    summaryBox.AddText("");
-    summaryBox.AddText(TString::Format("Ladder: %s", TString(gState.currentLadder).Data()));
-    summaryBox.AddText(TString::Format("Report generated: %s %s", __DATE__, __TIME__));
-    summaryBox.AddText("");
-
-    // Calculate totals and success rate
-    int totalDirs = gState.goodDirs + gState.auxDirs + gState.missextraDirs+gState.errorDirs;
-    summaryBox.AddText(TString::Format("Total directories: %d", totalDirs));
-    summaryBox.AddText(TString::Format("Directories with consistent data: %d", gState.goodDirs));
-    summaryBox.AddText(TString::Format("Directories with inconsistent data (auxiliary files found): %d", gState.auxDirs));
-    summaryBox.AddText(TString::Format("Directories with inconsistent data (missing/extra files): %d", gState.missextraDirs));
-    summaryBox.AddText(TString::Format("Directories with access errors: %d", gState.errorDirs));
-    summaryBox.AddText(TString::Format("Success rate: %.1f%%", (totalDirs > 0 ? 100.0 * (gState.goodDirs + gState.auxDirs) / totalDirs : 0)));
-
-    // Style the summary box
-    summaryBox.SetTextAlign(12);  // Center alignment
-    summaryBox.SetTextSize(0.03);
-    summaryBox.SetFillColor(0);   // Transparent background
-    summaryBox.SetBorderSize(1);
-    summaryBox.Draw();
-    
-    // -------------------------------------------------------------------
-    // BOTTOM SECTION: PIE CHART VISUALIZATION
-    // -------------------------------------------------------------------
-    canvas.cd(2); // Activate bottom section
-
-    if (totalDirs > 0) {
-        // Create pie chart with three segments
-        TPie* pie = new TPie("pie", "", 3);
-        
-        // Position and size the pie chart
-        pie->SetCircle(0.3, 0.5, 0.2);
-        
-        // Add data segments with colors
-        pie->SetEntryVal(0, gState.goodDirs);
-        pie->SetEntryLabel(0, "");
-        pie->SetEntryFillColor(0, kGreen);
-
-        pie->SetEntryVal(1, gState.auxDirs);
-        pie->SetEntryLabel(1, "");
-        pie->SetEntryFillColor(1, kOrange);
-
-        pie->SetEntryVal(2, gState.missextraDirs);
-        pie->SetEntryLabel(2, "");
-        pie->SetEntryFillColor(2, kRed);
-
-        pie->SetEntryVal(3, gState.errorDirs);
-        pie->SetEntryLabel(3, "");
-        pie->SetEntryFillColor(3, kViolet);
-
-        // Draw the pie chart
-        pie->Draw("rsc");
-
-        // Create and position the legend
-        TLegend* legend = new TLegend(0.6, 0.5, 0.95, 0.85);
-        legend->SetHeader("Validation Results", "C");
-        legend->SetTextSize(0.03);
-        legend->SetBorderSize(1);
-        legend->SetFillColor(0);
-
-        // Add legend entries with percentages
-        legend->AddEntry("", TString::Format("Consistent: %d (%.1f%%)", 
-            gState.goodDirs, 100.0*gState.goodDirs/totalDirs), "");
-        legend->AddEntry("", TString::Format("Auxiliary: %d (%.1f%%)", 
-            gState.auxDirs, 100.0*gState.auxDirs/totalDirs), "");
-        legend->AddEntry("", TString::Format("Missing/Extra: %d (%.1f%%)", 
-            gState.missextraDirs, 100.0*gState.missextraDirs/totalDirs), "");
-        legend->AddEntry("", TString::Format("Access error: %d (%.1f%%)", 
-            gState.errorDirs, 100.0*gState.errorDirs/totalDirs), "");
-
-        legend->Draw();
-    } else {
-        // Handle case with no directories
-        TPaveText noData(0.1, 0.1, 0.9, 0.9);
-        noData.AddText("No validation data available")->SetTextColor(kRed);
-        noData.Draw();
-    }
-    
-    // Output the summary page to PDF
-    canvas.Print(filename);
-    
-    // ===================================================================
-    // FOLLOWING PAGES: DETAILED DIRECTORY REPORTS
-    // ===================================================================
-    for (const auto& report : gState.reportPages) {
-        canvas.Clear();
-        canvas.cd(); // Use full canvas for directory reports
-        
-        // Create text box for report content      
-        TPaveText textBox(0.05, 0.05, 0.95, 0.95);
-        textBox.SetTextAlign(12);   // Left alignment
-        textBox.SetTextSize(0.025);
-        textBox.SetFillColor(0);    // Transparent background
-        textBox.SetBorderSize(1);
-        
-        // Parse the report text line by line
-        std::istringstream stream(report);
-        std::string line;
-        bool isFailedFolder = false;
-        
-        while (std::getline(stream, line)) {
-            // Skip empty lines
-            if (line.empty()) continue;
-            
-            // Handle status line with color coding
-            if (line.find("STATUS:") != std::string::npos) {
-                if (line.find("DIRECTORY ERROR") != std::string::npos) {
-                    textBox.AddText(line.c_str())->SetTextColor(kViolet);
-                    isFailedFolder = true;
-                }
-                 else if (line.find("DATA INCONSISTENT (MISSING/EXTRA)") != std::string::npos) {
-                    textBox.AddText(line.c_str())->SetTextColor(kRed);
-                    isFailedFolder = true;
-                } 
-                else if (line.find("DATA INCONSISTENT (AUXILIARY FILES)") != std::string::npos) {
-                    textBox.AddText(line.c_str())->SetTextColor(kOrange);
-                    isFailedFolder = true;
-                }
-                else if (line.find("DATA CONSISTENT") != std::string::npos) {
-                    textBox.AddText(line.c_str())->SetTextColor(kGreen+2);
-                    isFailedFolder = false;
-                }
-                continue;
-            }
-            
-            // Handle log file status line
-            if (line.find("Log file:") != std::string::npos) {
-                size_t colonPos = line.find(":");
-                if (colonPos != std::string::npos) {
-                    std::string prefix = line.substr(0, colonPos + 1);
-                    std::string rest = line.substr(colonPos + 1);
-        
-                    textBox.AddText(prefix.c_str());
-                     if (rest.find("FOUND") != std::string::npos) {
-                        textBox.AddText(rest.c_str())->SetTextColor(kGreen+2);
-                    } else if (rest.find("MISSING") != std::string::npos) {
-                        textBox.AddText(rest.c_str())->SetTextColor(kRed);
-                    } else {
-                        textBox.AddText(rest.c_str());
-                    }
-                } else {
-                     textBox.AddText(line.c_str());
-                }
-                continue;
-            }
-
-            // Handle module files status line
-            if (line.find("Module files:") != std::string::npos) {
-                size_t colonPos = line.find(":");
-                if (colonPos != std::string::npos) {
-                    std::string prefix = line.substr(0, colonPos + 1);
-                    std::string rest = line.substr(colonPos + 1);
-        
-                    textBox.AddText(prefix.c_str());
-                    if (rest.find("ERROR") != std::string::npos) {
-                        textBox.AddText(rest.c_str())->SetTextColor(kRed);
-                    } else if (rest.find("OK") != std::string::npos) {
-                        textBox.AddText(rest.c_str())->SetTextColor(kGreen+2);
-                    } else {
-                        textBox.AddText(rest.c_str());
-                    }
-                    } else {
-                        textBox.AddText(line.c_str());
-                    }
-                continue;
-            }
-            
-            // Highlight invalid files sections
-            if (line.find("Invalid log data files:") != std::string::npos ||
-                line.find("Module test file errors:") != std::string::npos) {
-                textBox.AddText(line.c_str())->SetTextColor(kRed);
-                continue;
-            }
-            
-            // Highlight individual file errors (lines starting with " - ")
-            if (line.find(" - ") == 0) {
-                textBox.AddText(line.c_str())->SetTextColor(kRed);
-                continue;
-            }
-            
-            // Individual file errors (lines starting with " - ")
-            if (line.find(" - ") == 0) {
-                textBox.AddText(line.c_str())->SetTextColor(kRed);
-                continue;
-            }
-            
-            // Color code count lines (X/8) based on correctness
-            if (line.find("files:") != std::string::npos || line.find("found:") != std::string::npos) {
-                size_t colonPos = line.find(":");
-                if (colonPos != std::string::npos) {
-                    std::string prefix = line.substr(0, colonPos + 1);
-                    std::string rest = line.substr(colonPos + 1);
-                    
-                    // Check if count is incorrect (looking for patterns like "X/8")
-                    bool isCountIncorrect = false;
-                    size_t slashPos = rest.find("/");
-                    if (slashPos != std::string::npos) {
-                        std::string countStr = rest.substr(0, slashPos);
-                        std::string expectedStr = rest.substr(slashPos + 1);
-    
-                        try {
-                            int count = std::stoi(countStr);
-                            int expected = std::stoi(expectedStr);
-                            if (count != expected) {
-                                isCountIncorrect = true;
-                            }
-                        } catch (const std::invalid_argument& e) {
-                            isCountIncorrect = true;
-                        } catch (const std::out_of_range& e) {
-                            isCountIncorrect = true;
-                        } 
-                    }                   
-                    // Add colored text
-                    textBox.AddText(prefix.c_str());
-                    if (isCountIncorrect) {
-                        textBox.AddText(rest.c_str())->SetTextColor(kRed);
-                    } else {
-                        textBox.AddText(rest.c_str())->SetTextColor(kGreen+2);
-                    }
-                } else {
-                    textBox.AddText(line.c_str());
-                }
-                continue;
-            }
-
-            // Special handling for Pscan section counts
-            if (line.find("Electron text:") != std::string::npos || 
-                line.find("Hole text:") != std::string::npos ||
-                line.find("Electron root:") != std::string::npos ||
-                line.find("Hole root:") != std::string::npos) {
-                
-                size_t colonPos = line.find(":");
-                if (colonPos != std::string::npos) {
-                    std::string prefix = line.substr(0, colonPos + 1);
-                    std::string rest = line.substr(colonPos + 1);
-                    
-                    // Color code count lines (X/8) based on correctness
-                    bool isCountCorrect = false;
-                    size_t slashPos = rest.find("/");
-                    if (slashPos != std::string::npos) {
-                        std::string countStr = rest.substr(0, slashPos);
-                        
-                        try {
-                            int count = std::stoi(countStr);
-                            if (count == 8) {
-                                isCountCorrect = true;
-                            }
-                        } catch (...) {
-                            // Ignore conversion errors
-                        }
-                    }
-                    
-                    // Add colored text
-                    textBox.AddText(prefix.c_str());
-                    if (isCountCorrect) {
-                        textBox.AddText(rest.c_str())->SetTextColor(kGreen+2);
-                    } else {
-                        textBox.AddText(rest.c_str())->SetTextColor(kRed);
-                    }
-                } else {
-                    textBox.AddText(line.c_str());
-                }
-                continue;
-            }
-            
-            // Highlight error and warning messages
-            if (line.find("Error:") != std::string::npos || 
-                line.find("Warning:") != std::string::npos) {
-                textBox.AddText(line.c_str())->SetTextColor(kOrange+7);
-                continue;
-            }
-            
-            // Default case - normal text
-            textBox.AddText(line.c_str());
-        }
-        
-        // Draw the text box and add to PDF
-        textBox.Draw();
-        canvas.Print(filename);
-    }
-    
-    // ===================================================================
-    // FINALIZE PDF DOCUMENT
-    // ===================================================================
-    /* Close the PDF document properly using ] */
-    canvas.Print(filename + "]");
-    std::cout << "PDF report saved to: " << filename << std::endl;
-}
-
-/*
- * GenerateGlobalSummary:
- * Creates a consolidated summary of all validation results with statistics and metrics.
- * This global summary appears at the end of reports and provides high-level insights.
- *
- * Parameters:
- *   totalDirs - Total number of directories processed (for percentage calculations)
- *
- * Operation:
- * 1. Calculates success rate and other metrics
- * 2. Formats results into a standardized summary block
- * 3. Stores the summary in gState.globalSummary for inclusion in reports
- * 4. Outputs the summary to console for immediate feedback
- *
- * Output Includes:
- * - Total directories processed
- * - Breakdown by status (passed/warning/failed)
- * - Success rate percentage
- * - Visual separators for readability
- */
-void GenerateGlobalSummary(int totalDirs) {
-    // Create a string stream to build the summary content
-    std::stringstream summary;
-
-    // ===================================================================
-    // SUMMARY HEADER
-    // ===================================================================
-    summary << "\n\n====================================================\n";
-    summary << "EXORCISM VALIDATION SUMMARY\n";
-    summary << "====================================================\n";
-
-    // ===================================================================
-    // CORE STATISTICS
-    // ===================================================================
-    /* Calculate success rate with protection against division by zero */
-    float successRate = totalDirs > 0 ? 
-        (100.0f * (gState.goodDirs + gState.auxDirs) / totalDirs) : 0.0f;
-
-    // Basic counts
-    summary << "Ladder:          " << gState.currentLadder << "\n";
-    summary << "Total directories:      " << totalDirs << "\n";
-    summary << "Directories with consistent data:    " << gState.goodDirs << "\n";
-    summary << "Directories with inconsistent data (auxiliary files found):     " << gState.auxDirs << "\n";
-    summary << "Directories with inconsistent data (Missing/Extra files):   " << gState.missextraDirs << "\n";
-    summary << "Directories with access errors:     " << gState.errorDirs << "\n";
-
-    // Success rate with fixed decimal precision
-    summary << "Success rate:    " << std::fixed << std::setprecision(1) 
-            << successRate << "%\n";
-
-    // ===================================================================
-    // ADDITIONAL METRICS (when applicable)
-    // ===================================================================
-    /* Include warning ratios if there are passed-with-issues cases */
-    if (gState.auxDirs > 0) {
-        float warningRate = 100.0f * gState.auxDirs / 
-                          (gState.goodDirs + gState.auxDirs);
-        summary << "Warning rate among passed: " << std::setprecision(1) 
-                << warningRate << "%\n";
-    }
-
-    /* Critical failure analysis */
-    if (gState.missextraDirs > 0 || gState.errorDirs > 0) {
-        float failureRate = 100.0f * (gState.missextraDirs +gState.errorDirs)/ totalDirs;
-        summary << "Critical failure rate: " << std::setprecision(1) 
-                << failureRate << "%\n";
-    }
-
-    // ===================================================================
-    // QUALITATIVE ASSESSMENT
-    // ===================================================================
-    summary << "\nOverall Status: ";
-    if (successRate >= 95.0f) {
-        summary << "EXCELLENT (≥95% success)";
-    } 
-    else if (successRate >= 80.0f) {
-        summary << "GOOD (≥80% success)";
-    }
-    else if (successRate >= 60.0f) {
-        summary << "FAIR (≥60% success)";
-    }
-    else {
-        summary << "POOR (<60% success)";
-    }
-
-    // ===================================================================
-    // FOOTER
-    // ===================================================================
-    summary << "\n====================================================\n";
-    summary << "End of Summary\n";
-    summary << "====================================================\n";
-
-    // ===================================================================
-    // STORE AND OUTPUT RESULTS
-    // ===================================================================
-    // Save to global state for inclusion in reports
-    gState.globalSummary = summary.str();
-
-    // Also print to console for immediate visibility
-    std::cout << gState.globalSummary << std::endl;
-}
-
-// ===================================================================
-// Directory Processing
-// ===================================================================
-/*
- * FindValidationDirectories:
- * Scans the current working directory to identify all potential validation directories.
- * 
- * Returns:
- *   std::vector<TString> - List of directory names that should be validated
- *
- * Operation:
- * 1. Gets list of all files/directories in current working directory
- * 2. Filters for valid directory names (excluding system directories)
- * 3. Returns names of candidate directories for validation
- *
- * Directory Selection Criteria:
- * - Must be a directory (not a file)
- * - Must not be "." or ".." (current/parent directory)
- * - Must not be hidden (names starting with '.')
- * - Must not be a known system directory
- */
-std::vector<TString> FindValidationDirectories() {
-    std::vector<TString> directories;  // Stores found directories
-    
-    // ===================================================================
-    // INITIALIZE DIRECTORY SCANNING
-    // ===================================================================
-    /* Create directory object for current working directory */
-    TSystemDirectory rootDir(".", ".");
-    
-    /* Get list of all entries in the directory */
-    TList* dirContents = rootDir.GetListOfFiles();
-    
-    // ===================================================================
-    // VALIDATION CHECKS
-    // ===================================================================
-    if (!dirContents) {
-        std::cerr << "Error: Could not read directory contents from current path." << std::endl;
-        return directories;  // Return empty vector on error
-    }
-
-    // ===================================================================
-    // PROCESS DIRECTORY ENTRIES
-    // ===================================================================
-    TIter next(dirContents);  // Create iterator for directory contents
-    TSystemFile* file;        // Pointer to current file/directory entry
-    
-    while ((file = (TSystemFile*)next())) {  // Iterate through all entries
-        TString fileName = file->GetName();  // Get entry name
-        
-        // ---------------------------------------------------------------
-        // FILTER OUT NON-DIRECTORIES
-        // ---------------------------------------------------------------
-        /* Skip if not a directory or special system entries */
-        if (!file->IsDirectory() || fileName == "." || fileName == "..") {
-            continue;
-        }
-        
-        // ---------------------------------------------------------------
-        // FILTER OUT HIDDEN DIRECTORIES
-        // ---------------------------------------------------------------
-        /* Skip hidden directories (common on Unix systems) */
-        if (fileName.BeginsWith(".")) {
-            continue;
-        }
-        
-        // ---------------------------------------------------------------
-        // FILTER OUT KNOWN SYSTEM DIRECTORIES
-        // ---------------------------------------------------------------
-        /* Skip common ROOT and system directories */
-        if (fileName == "root" || fileName == "sys" || fileName == "etc") {
-            continue;
-        }
-        
-        // ---------------------------------------------------------------
-        // ADD VALID DIRECTORY TO RESULTS
-        // ---------------------------------------------------------------
-        /* If all checks passed, add to our list */
-        directories.push_back(fileName);
-    }
-
-    // ===================================================================
-    // CLEANUP AND RETURN RESULTS
-    // ===================================================================
-    delete dirContents;  // Free the directory listing
-    
-    // Log findings to console
-    std::cout << "Found " << directories.size() 
-              << " potential validation directories." << std::endl;
-    
-    return directories;
-}
-
-// ===================================================================
-// File Cleanup Function
-// ===================================================================
-/*
- * Extra_Omnes:
- * Performs interactive cleanup of problematic files identified during validation.
- * Latin for "all others out", this function handles all remaining file issues.
- *
- * Operation:
- * 1. Identifies problematic files from validation results
- * 2. Groups files by error type (invalid, empty, unexpected)
- * 3. Prompts user for confirmation before deletion
- * 4. Tracks successful/failed deletions
- * 5. Generates cleanup report
- *
- * Safety Features:
- * - Interactive confirmation for each deletion group
- * - Preserves original files if deletion fails
- * - Comprehensive logging of all actions
- */
-void Extra_Omnes() {
-    std::cout << "\n===== FILE CLEANUP PROCEDURE =====" << std::endl;
-    std::cout << "This will remove problematic files after confirmation." << std::endl;
-    
-    // ===================================================================
-    // TRACKING VARIABLES
-    // ===================================================================
-    std::vector<std::string> deletedFiles;      // Successfully deleted files
-    std::vector<std::string> failedDeletions;   // Files that couldn't be deleted
-    
-    // ===================================================================
-    // PROCESS ALL DIRECTORIES
-    // ===================================================================
-    std::vector<TString> directories = FindValidationDirectories();
-    for (const auto& dir : directories) {
-        // Run validators to get complete error lists
-        ValidationResult logResult = CheckLogFiles(dir.Data());
-        ValidationResult trimResult = CheckTrimFiles(dir.Data());
-        ValidationResult pscanResult = CheckPscanFiles(dir.Data());
-        ValidationResult connResult = CheckConnFiles(dir.Data());
-
-        // ===============================================================
-        // 1. PROCESS DATA-TESTER PAIRS
-        // ===============================================================
-        if (logResult.dataFileCount > 0) {
-            TSystemDirectory dirObj(dir, dir);
-            TList* files = dirObj.GetListOfFiles();
-            if (files) {
-                std::vector<std::pair<TString, TString>> dataTesterPairs;
-                std::map<TString, bool> testerFileMap;
-
-                // Collect all tester files first
-                TSystemFile* file;
-                TIter next(files);
-                while ((file = (TSystemFile*)next())) {
-                    TString fileName = file->GetName();
-                    if (fileName.BeginsWith("tester_febs_") && fileName.Contains("_arr_")) {
-                        testerFileMap[fileName] = false; // Mark as unmatched
-                    }
-                }
-
-                // Match data files with testers
-                TIter next2(files);
-                while ((file = (TSystemFile*)next2())) {
-                    TString fileName = file->GetName();
-                    if (fileName.BeginsWith(dir) && fileName.EndsWith("_data.dat")) {
-                        TString dataPattern;
-                        bool isSpecialCase = false;
-
-                        // Check for standard format: "folder_YYMMDD_HHMM_data.dat"
-                        if (fileName.Length() == (15 + 1 + 6 + 1 + 4 + 9)) {
-                            dataPattern = fileName(16, 11); // Extract YYMMDD_HHMM
-                        } 
-                        // Check for special case: "folder_data.dat"
-                        else if (fileName == TString::Format("%s_data.dat", dir.Data())) {
-                            isSpecialCase = true;
-                        } else {
-                            continue; // Skip unexpected formats
-                        }
-
-                        // Find matching tester file
-                        TString matchedTester;
-                        if (isSpecialCase) {
-                            // Special case: match with oldest available tester
-                            for (auto& tester : testerFileMap) {
-                                if (!tester.second) {
-                                    matchedTester = tester.first;
-                                    tester.second = true;
-                                    break;
-                                }
-                            }
-                        } else {
-                            // Normal case: match by exact pattern
-                            for (auto& tester : testerFileMap) {
-                                Ssiz_t arrPos = tester.first.Index("_arr_");
-                                if (arrPos != kNPOS && !tester.second) {
-                                    TString testerPattern = tester.first(arrPos + 5, 11);
-                                    if (dataPattern == testerPattern) {
-                                        matchedTester = tester.first;
-                                        tester.second = true;
-                                        break;
-                                    }
-                                }
-                            }
-                        }
-
-                        dataTesterPairs.emplace_back(fileName, matchedTester);
-                    }
-                }
-
-                // Process invalid data files and their testers
-                for (const auto& invalidFile : logResult.invalidFiles) {
-                    // Skip log files from deletion
-                    if (TString(invalidFile.c_str()).EndsWith(".log")) {
-                        continue;
-                    }
-
-                    // Find matching pair
-                    for (const auto& pair : dataTesterPairs) {
-                        if (pair.first == invalidFile) {
-                            std::cout << "\n===== INVALID DATA-TESTER PAIR =====" << std::endl;
-                            std::cout << "Data file: " << pair.first << std::endl;
-                            if (!pair.second.IsNull()) {
-                                std::cout << "Matched tester file: " << pair.second << std::endl;
-                            } else {
-                                std::cout << "No matching tester file found" << std::endl;
-                            }
-
-                            // Interactive confirmation
-                            std::cout << "Delete this file pair? (y/n): ";
-                            std::string response;
-                            std::getline(std::cin, response);
-                            
-                            if (response == "y" || response == "Y") {
-                                // Delete data file
-                                TString dataPath = dir + "/" + pair.first;
-                                if (gSystem->Unlink(dataPath.Data())) {
-                                    deletedFiles.push_back(pair.first.Data());
-                                    std::cout << "Deleted data file: " << pair.first << std::endl;
-                                } else {
-                                    failedDeletions.push_back(pair.first.Data());
-                                    std::cout << "Failed to delete data file: " << pair.first << std::endl;
-                                }
-
-                                // Delete tester file if exists
-                                if (!pair.second.IsNull()) {
-                                    TString testerPath = dir + "/" + pair.second;
-                                    if (gSystem->Unlink(testerPath.Data())) {
-                                        deletedFiles.push_back(pair.second.Data());
-                                        std::cout << "Deleted tester file: " << pair.second << std::endl;
-                                    } else {
-                                        failedDeletions.push_back(pair.second.Data());
-                                        std::cout << "Failed to delete tester file: " << pair.second << std::endl;
-                                    }
-                                }
-                            }
-                            break;
-                        }
-                    }
-                }
-                delete files;
-            }
-        }
-
-        // ===============================================================
-        // 2. PROCESS OTHER PROBLEMATIC FILES
-        // ===============================================================
-        struct FileCategory {
-            std::string name;
-            std::vector<std::string> files;
-            TString subdir;
-            bool checkFormat;
-        };
-
-        // Define cleanup categories
-        std::vector<FileCategory> categories = {
-            {"Empty log data files", logResult.emptyFiles, "", false},
-            {"Unexpected files in log directory", logResult.unexpectedFiles, "", false},
-            {"Empty pscan files", pscanResult.emptyFiles, "pscan_files", false},
-            {"Module test file errors", pscanResult.moduleErrorFiles, "pscan_files", false},
-            {"Unexpected files in pscan directory", pscanResult.unexpectedFiles, "pscan_files", false}
-        };
-
-        // Filter out log files from all categories
-        for (auto& category : categories) {
-            category.files.erase(
-                std::remove_if(
-                    category.files.begin(),
-                    category.files.end(),
-                    [](const std::string& file) {
-                        return TString(file.c_str()).EndsWith(".log");
-                    }
-                ),
-                category.files.end()
-            );
-        }
-
-        for (auto& category : categories) {
-            if (category.files.empty()) continue;
-            
-            std::cout << "\n===== " << category.name << " =====" << std::endl;
-            std::cout << "Found " << category.files.size() << " files:" << std::endl;
-            for (const auto& file : category.files) {
-                std::cout << " - " << file << std::endl;
-            }
-            
-            // Interactive confirmation
-            std::cout << "\nDelete these " << category.files.size() << " files? (y/n): ";
-            std::string response;
-            std::getline(std::cin, response);
-            
-            if (response == "y" || response == "Y") {
-                for (const auto& file : category.files) {
-                    TString fullPath = dir + "/";
-                    if (!category.subdir.IsNull()) {
-                        fullPath += category.subdir + "/";
-                    }
-                    fullPath += file.c_str();
-                    
-                    if (gSystem->Unlink(fullPath.Data())) {
-                        deletedFiles.push_back(file);
-                    } else {
-                        failedDeletions.push_back(file);
-                    }
-                }
-                std::cout << "Deleted " << category.files.size() << " files." << std::endl;
-            }
-        }
-
-        // ===============================================================
-        // 3. SPECIAL HANDLING FOR TRIM AND CONN FILES
-        // ===============================================================
-        auto processProtectedFiles = [&](const std::vector<std::string>& files, 
-                                        const TString& subdir, 
-                                        const std::string& categoryName) {
-            if (files.empty()) return;
-
-            std::vector<std::string> invalidFormatFiles;
-            for (const auto& file : files) {
-                TString fileName(file.c_str());
-                
-                // Skip log files
-                if (fileName.EndsWith(".log")) {
-                    continue;
-                }
-
-                // Check file name format
-                bool validFormat = false;
-                if (subdir == "trim_files") {
-                    validFormat = fileName.EndsWith("_elect.txt") || fileName.EndsWith("_holes.txt");
-                } else if (subdir == "conn_check_files") {
-                    validFormat = fileName.EndsWith("_elect.txt") || fileName.EndsWith("_holes.txt");
-                }
-
-                if (!validFormat) {
-                    invalidFormatFiles.push_back(file);
-                }
-            }
-
-            if (!invalidFormatFiles.empty()) {
-                std::cout << "\n===== INVALID FORMAT FILES IN " << subdir << " =====" << std::endl;
-                std::cout << "Found " << invalidFormatFiles.size() << " files with wrong format:" << std::endl;
-                for (const auto& file : invalidFormatFiles) {
-                    std::cout << " - " << file << std::endl;
-                }
-                
-                // Interactive confirmation
-                std::cout << "\nDelete these " << invalidFormatFiles.size() 
-                          << " invalid format files? (y/n): ";
-                std::string response;
-                std::getline(std::cin, response);
-                
-                if (response == "y" || response == "Y") {
-                    for (const auto& file : invalidFormatFiles) {
-                        TString fullPath = dir + "/" + subdir + "/" + file.c_str();
-                        if (gSystem->Unlink(fullPath.Data())) {
-                            deletedFiles.push_back(file);
-                        } else {
-                            failedDeletions.push_back(file);
-                        }
-                    }
-                    std::cout << "Deleted " << invalidFormatFiles.size() << " files." << std::endl;
-                }
-            }
-        };
-
-        // Process trim and conn files with special rules
-        processProtectedFiles(trimResult.unexpectedFiles, "trim_files", "Unexpected files in trim directory");
-        processProtectedFiles(connResult.unexpectedFiles, "conn_check_files", "Unexpected files in connection directory");
-    }
-    
-    // ===================================================================
-    // GENERATE CLEANUP REPORT
-    // ===================================================================
-    std::stringstream cleanupReport;
-    cleanupReport << "\n===== FILE CLEANUP REPORT =====" << std::endl;
-    cleanupReport << "Total deleted files: " << deletedFiles.size() << std::endl;
-    cleanupReport << "Total failed deletions: " << failedDeletions.size() << std::endl;
-    
-    if (!deletedFiles.empty()) {
-        cleanupReport << "\nSuccessfully deleted files:" << std::endl;
-        for (const auto& file : deletedFiles) {
-            cleanupReport << " - " << file << std::endl;
-        }
-    }
-    
-    if (!failedDeletions.empty()) {
-        cleanupReport << "\nFailed to delete:" << std::endl;
-        for (const auto& file : failedDeletions) {
-            cleanupReport << " - " << file << std::endl;
-        }
-    }
-    
-    // Add to global report
-    gState.globalSummary += cleanupReport.str();
-    
-    std::cout << cleanupReport.str() << std::endl;
-}
-// ===================================================================
-// Main Function - Exorcism
-// ===================================================================
-/*
- * Exorcism:
- * Main driver function that orchestrates the entire validation process.
- * Performs complete validation of ladder test data directories including:
- * - Directory discovery
- * - Two-pass validation (before/after cleanup)
- * - Comprehensive report generation
- * - Interactive cleanup of problematic files
- *
- * Operation Flow:
- * 1. Initializes global state
- * 2. Discovers validation directories
- * 3. First validation pass (pre-cleanup)
- * 4. Generates initial reports
- * 5. Performs interactive cleanup
- * 6. Second validation pass (post-cleanup)
- * 7. Generates final reports
- * 8. Provides completion summary
- */
-void Exorcism() {
-    // ===================================================================
-    // INITIALIZATION
-    // ===================================================================
-    /* Set current ladder name from working directory */
-    gState.currentLadder = gSystem->BaseName(gSystem->WorkingDirectory());
-    
-    /* Print startup banner */
-    std::cout << "Starting EXORCISM validation for ladder: " 
-              << gState.currentLadder << std::endl;
-    std::cout << "====================================================" << std::endl;
-
-    // ===================================================================
-    // DIRECTORY DISCOVERY
-    // ===================================================================
-    /* Find all candidate directories for validation */
-    std::vector<TString> directories = FindValidationDirectories();
-    if (directories.empty()) {
-        std::cout << "No validation directories found!" << std::endl;
-        return;  // Exit if nothing to validate
-    }
-    
-    std::cout << "Found " << directories.size() 
-              << " directories to validate" << std::endl;
-    std::cout << "====================================================\n" << std::endl;
-
-    // ===================================================================
-    // FIRST VALIDATION PASS (BEFORE CLEANUP)
-    // ===================================================================
-    std::cout << "\n===== FIRST VALIDATION PASS (BEFORE CLEANUP) =====" << std::endl;
-    
-    /* Process each directory and generate reports */
-    for (const auto& dir : directories) {
-        GenerateReportPage(dir);
-    }
-    
-    /* Generate initial summary statistics */
-    GenerateGlobalSummary(directories.size());
-    
-    // ===================================================================
-    // SAVE PRE-CLEANUP REPORTS
-    // ===================================================================
-    /* Create timestamp for report filenames */
-    TString timestamp = TString::Format("_%s_%s", __DATE__, __TIME__);
-    timestamp.ReplaceAll(" ", "_");  // Fix spaces in date
-    timestamp.ReplaceAll(":", "-");  // Fix colons in time
-    
-    /* Create report filenames with ladder name and timestamp */
-    TString beforeTxt = TString::Format("ExorcismReport_%s%s_before.txt", 
-                                      gState.currentLadder.c_str(), timestamp.Data());
-    TString beforeRoot = TString::Format("ExorcismReport_%s%s_before.root", 
-                                       gState.currentLadder.c_str(), timestamp.Data());
-    TString beforePdf = TString::Format("ExorcismReport_%s%s_before.pdf", 
-                                      gState.currentLadder.c_str(), timestamp.Data());
-    
-    /* Save reports in all formats */
-    std::cout << "\nSaving pre-cleanup reports..." << std::endl;
-    SaveTxtReport(beforeTxt);
-    SaveRootReport(beforeRoot);
-    SavePdfReport(beforePdf);
-
-    // ===================================================================
-    // INTERACTIVE CLEANUP
-    // ===================================================================
-    /* Perform guided cleanup of problematic files */
-    Extra_Omnes();
-    
-    // ===================================================================
-    // PREPARE FOR SECOND VALIDATION PASS
-    // ===================================================================
-    /* Reset global state while preserving ladder name */
-    std::string ladderName = gState.currentLadder;  // Save
-    gState = GlobalState();  // Reset all counters and reports
-    gState.currentLadder = ladderName;  // Restore
-    
-    // ===================================================================
-    // SECOND VALIDATION PASS (AFTER CLEANUP)
-    // ===================================================================
-    std::cout << "\n===== SECOND VALIDATION PASS (AFTER CLEANUP) =====" << std::endl;
-    
-    /* Re-validate all directories */
-    for (const auto& dir : directories) {
-        GenerateReportPage(dir);
-    }
-    
-    /* Generate post-cleanup summary */
-    GenerateGlobalSummary(directories.size());
-    
-    // ===================================================================
-    // SAVE POST-CLEANUP REPORTS
-    // ===================================================================
-    /* Create report filenames for post-cleanup */
-    TString afterTxt = TString::Format("ExorcismReport_%s%s_after.txt", 
-                                     gState.currentLadder.c_str(), timestamp.Data());
-    TString afterRoot = TString::Format("ExorcismReport_%s%s_after.root", 
-                                      gState.currentLadder.c_str(), timestamp.Data());
-    TString afterPdf = TString::Format("ExorcismReport_%s%s_after.pdf", 
-                                     gState.currentLadder.c_str(), timestamp.Data());
-    
-    /* Save final reports */
-    std::cout << "\nSaving post-cleanup reports..." << std::endl;
-    SaveTxtReport(afterTxt);
-    SaveRootReport(afterRoot);
-    SavePdfReport(afterPdf);
-
-    // ===================================================================
-    // COMPLETION SUMMARY
-    // ===================================================================
-    std::cout << "\nValidation complete! Two sets of reports generated:" << std::endl;
-    std::cout << "Pre-cleanup reports:" << std::endl;
-    std::cout << " - Text: " << beforeTxt << std::endl;
-    std::cout << " - ROOT: " << beforeRoot << std::endl;
-    std::cout << " - PDF:  " << beforePdf << std::endl;
-    
-    std::cout << "\nPost-cleanup reports:" << std::endl;
-    std::cout << " - Text: " << afterTxt << std::endl;
-    std::cout << " - ROOT: " << afterRoot << std::endl;
-    std::cout << " - PDF:  " << afterPdf << std::endl;
-    
-}
-
-int main() {
-    Exorcism();
-    return 0;
-
-}
+/*
+ * EXORCISM - Ladder Test Data Validation System
+ * Copyright (c) 2025 Nikodem Witkowski
+ * Licensed under the MIT License
+ * 
+ * This program performs comprehensive validation of ladder test data
+ * directory structures and files. It checks for required files, naming conventions,
+ * content validity, and generates detailed reports before/after cleanup operations.
+ */
+
+// Standard C++ Library Headers
+#include <iostream>   // For console input/output operations
+#include <fstream>    // For file stream operations
+#include <vector>     // For dynamic array functionality
+#include <string>     // For string manipulation
+#include <cstring>    // For memcmp/memmem/memchr/strerror
+#include <sstream>    // For string stream processing
+#include <iomanip>    // For output formatting
+#include <ctime>      // For date/time functions
+#include <map>        // For key-value pair storage
+#include <algorithm>  // For sorting/searching algorithms
+#include <set>        // For unique element storage
+#include <unordered_map> // For hash-indexed lookups
+#include <thread>     // For parallel validation workers
+#include <mutex>      // For shared state synchronization
+#include <condition_variable> // For worker queue signaling
+#include <future>     // For asynchronous task results
+#include <type_traits> // For thread pool task result types
+#include <functional> // For type-erased worker tasks
+#include <queue>      // For pending task storage
+#include <array>      // For fixed-size per-directory task slots
+#include <bitset>     // For seen-HW-index tracking
+#include <memory>     // For shared ownership of output streams
+#include <atomic>     // For lock-free instrumentation counters
+#include <chrono>     // For stage and per-file timing
+#include <string_view> // For allocation-free file name classification
+#include <climits>    // For INT_MAX
+#include <cstdlib>    // For strtol
+#include <cctype>     // For isdigit
+#include <dirent.h>   // For POSIX directory reading
+#include <fnmatch.h>  // For --include/--exclude patterns
+#include <cerrno>     // For system call error codes
+#include <sys/stat.h> // For file metadata queries
+#include <fcntl.h>    // For low-level file opening
+#include <unistd.h>   // For pread/close
+#include <dlfcn.h>    // For loading the PDF plugin
+#include <poll.h>     // For waiting on file system events
+#include <csignal>    // For stopping watch mode with Ctrl-C
+#ifdef __linux__
+#include <sys/inotify.h> // For watch mode file system events
+#endif
+
+// ROOT Framework Headers (Data Analysis)
+#include <TSystem.h>              // System interface utilities
+#include <TString.h>              // ROOT string implementation
+#include <TFile.h>                // ROOT file I/O operations
+#include <TROOT.h>                // ROOT thread-safety switch
+#include <TObjString.h>           // String object wrapper
+#include <TTree.h>                // Structured (columnar) report storage
+#include <TInterpreter.h>         // C++ interpreter
+// Graphics headers are only used by the PDF plugin (ExorcismPdf.C)
+
+// ===================================================================
+// Global Constants and Structures
+// ===================================================================
+
+/*
+ * Evaluation Status Levels:
+ * These constants define the possible validation outcomes
+ */
+#define STATUS_DATA_CONSISTENT                  0       // All checks successful
+#define STATUS_DATA_INCONSISTENT_AUXILIARY      1       // Auxiliary files found but not critical
+#define STATUS_DATA_INCONSISTENT_MISSING_EXTRA  2       // Missing/Extra files error
+#define STATUS_DIRECTORY_ERROR                  3       // Directory access error
+
+#define EXIT_INVALID_OPTIONS                    4       // Exorcism(): an option was rejected, nothing done
+
+const char* const kStatusNames[] = {  // Status labels, indexed by STATUS_*
+    "DATA CONSISTENT", "DATA INCONSISTENT (AUXILIARY FILES)",
+    "DATA INCONSISTENT (MISSING/EXTRA)", "DIRECTORY ERROR"
+};
+
+/*
+ * Log Files Validation Flags (Bitmask):
+ * Each flag represents a specific validation failure condition
+ */
+#define FLAG_DIR_MISSING         0x01   // Target directory not found
+#define FLAG_LOG_MISSING         0x02   // Main log file missing
+#define FLAG_DATA_MISSING        0x04   // Required data files missing
+#define FLAG_NO_FEB_FILE         0x08   // Matching tester FEB file missing
+#define FLAG_FILE_OPEN           0x10   // File access error
+#define FLAG_DATA_EMPTY          0x20   // Empty data file
+#define FLAG_DATA_INVALID        0x40   // Invalid file content
+#define FLAG_UNEXPECTED_FILES    0x80   // Unexpected files in directory
+
+/*
+ * Connection Files Validation Flags:
+ * Specific flags for connection test files
+ */
+#define FLAG_CONN_FOLDER_MISSING 0x01   // conn_check_files directory missing
+#define FLAG_DIR_ACCESS          0x02   // Directory access error
+#define FLAG_ELECTRON_COUNT      0x04   // Incorrect electron file count
+#define FLAG_HOLE_COUNT          0x08   // Incorrect hole file count
+#define FLAG_FILE_OPEN_CONN      0x10   // Connection file access error
+#define FLAG_UNEXPECTED_FILES_CONN 0x20 // Unexpected files in connection dir
+
+/*
+ * Trim Files Validation Flags:
+ * Specific flags for trim adjustment files
+ */
+#define FLAG_TRIM_FOLDER_MISSING 0x01   // trim_files directory missing
+#define FLAG_DIR_ACCESS_TRIM     0x02   // Directory access error
+#define FLAG_ELECTRON_COUNT_TRIM 0x04   // Incorrect electron file count
+#define FLAG_HOLE_COUNT_TRIM     0x08   // Incorrect hole file count
+#define FLAG_FILE_OPEN_TRIM      0x10   // Trim file access error
+#define FLAG_UNEXPECTED_FILES_TRIM 0x20 // Unexpected files in trim dir
+
+/*
+ * Pscan Files Validation Flags:
+ * Specific flags for parameter scan files
+ */
+#define FLAG_PSCAN_FOLDER_MISSING 0x01  // pscan_files directory missing
+#define FLAG_DIR_ACCESS_PSCAN    0x02   // Directory access error
+#define FLAG_ELECTRON_TXT        0x04   // Incorrect electron txt count
+#define FLAG_HOLE_TXT            0x08   // Incorrect hole txt count
+#define FLAG_ELECTRON_ROOT       0x10   // Incorrect electron root count
+#define FLAG_HOLE_ROOT           0x20   // Incorrect hole root count
+#define FLAG_FILE_OPEN_PSCAN     0x40   // Pscan file access error
+#define FLAG_UNEXPECTED_FILES_PSCAN 0x80 // Unexpected files in pscan dir
+#define FLAG_MODULE_ROOT         0x100  // Module root file error
+#define FLAG_MODULE_TXT          0x200  // Module text file error
+#define FLAG_MODULE_PDF          0x400  // Module PDF file missing
+
+/*
+ * Validator Selection Masks:
+ * Identify the four validators (and the subfolder each one reads)
+ */
+#define CHECK_LOG                0x01   // Test directory itself (CheckLogFiles)
+#define CHECK_TRIM               0x02   // trim_files (CheckTrimFiles)
+#define CHECK_PSCAN              0x04   // pscan_files (CheckPscanFiles)
+#define CHECK_CONN               0x08   // conn_check_files (CheckConnFiles)
+#define CHECK_ALL                0x0F   // All four validators
+
+/*
+ * Report Output Formats:
+ * Selected with --formats; any combination can be written
+ */
+#define FORMAT_TXT               0x01   // Plain text report
+#define FORMAT_ROOT              0x02   // ROOT file with report objects
+#define FORMAT_PDF               0x04   // Graphical report (loads the graphics libraries)
+#define FORMAT_JSON              0x08   // JSON Lines, streamed one record per directory
+#define FORMAT_CSV               0x10   // CSV, streamed one row per directory
+#define FORMAT_PAGES             0x07   // Formats rendered from the report pages
+#define FORMAT_STREAMS           0x18   // Formats written while validating
+#define FORMAT_DEFAULT           0x07   // txt, root and pdf
+
+/*
+ * Verbosity Levels:
+ * Console output of the validators, selected with --verbosity
+ */
+#define VERBOSITY_QUIET          0      // One status line per directory
+#define VERBOSITY_NORMAL         1      // Validator output, written once per directory
+#define VERBOSITY_VERBOSE        2      // Adds per-file tracing, written as it happens
+
+/*
+ * Cleanup Modes and Policies:
+ * Selected with --cleanup and --cleanup-policy
+ */
+#define CLEANUP_INTERACTIVE      0      // Confirm every group of files
+#define CLEANUP_PLAN             1      // Write the proposed deletions to a manifest only
+#define CLEANUP_APPLY            2      // Delete everything listed in the manifest
+#define CLEANUP_NONE             3      // No cleanup and no second pass
+
+#define POLICY_ASK               0      // Ask for every group
+#define POLICY_AUTO_EMPTY        1      // Delete empty files without asking
+#define POLICY_AUTO_ALL          2      // Delete everything without asking
+
+#define CLEANUP_GROUP_PAIR       0      // Invalid data file and its tester file
+#define CLEANUP_GROUP_CATEGORY   1      // Problem files of one category
+#define CLEANUP_GROUP_FORMAT     2      // Wrong-format files of one folder
+
+#define CLEANUP_MANIFEST_HEADER  "# EXORCISM cleanup manifest v3"
+#define QUARANTINE_PREFIX        ".exorcism_quarantine_"  // + run time, inside the ladder folder
+#define SHARD_RESULTS_HEADER     "# EXORCISM shard results v1"
+
+/*
+ * NameList:
+ * Append-only list of file names packed back to back into one buffer
+ * (a small per-list arena). Adding a name copies it into the buffer
+ * instead of allocating a std::string; elements are std::string_view
+ * into the buffer and stay valid until the next push_back.
+ */
+class NameList {
+public:
+    class const_iterator {
+    public:
+        const_iterator(const NameList* list, size_t index) : list(list), index(index) {}
+        std::string_view operator*() const { return (*list)[index]; }
+        const_iterator& operator++() { index++; return *this; }
+        bool operator!=(const const_iterator& other) const { return index != other.index; }
+    private:
+        const NameList* list;
+        size_t index;
+    };
+
+    void push_back(std::string_view name) {
+        names.append(name.data(), name.size());
+        ends.push_back(names.size());
+    }
+
+    std::string_view operator[](size_t index) const {
+        size_t begin = index ? ends[index - 1] : 0;
+        return std::string_view(names).substr(begin, ends[index] - begin);
+    }
+
+    size_t size() const { return ends.size(); }
+    bool empty() const { return ends.empty(); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, ends.size()); }
+
+private:
+    std::string names;          // All names, back to back
+    std::vector<size_t> ends;   // End offset of each name in names
+};
+
+/*
+ * HasPrefix / HasSuffix:
+ * Allocation-free name tests for std::string_view file names
+ */
+inline bool HasPrefix(std::string_view text, std::string_view prefix) {
+    return text.size() >= prefix.size() && text.compare(0, prefix.size(), prefix) == 0;
+}
+
+inline bool HasSuffix(std::string_view text, std::string_view suffix) {
+    return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+/*
+ * ValidationResult Structure:
+ * Contains all validation results for a single test directory
+ */
+struct ValidationResult {
+    int flags = 0;  // Bitmask of encountered issues
+    
+    // Error file collections
+    NameList openErrorFiles;    // Files that couldn't be opened
+    NameList unexpectedFiles;   // Unexpected files found
+    NameList emptyFiles;        // Empty files found
+    NameList invalidFiles;      // Files with invalid content
+    NameList moduleErrorFiles;  // Module test file errors
+    
+    // Log files specific counters
+    int dataFileCount = 0;      // Total data files found
+    int nonEmptyDataCount = 0;  // Non-empty data files
+    int validDataCount = 0;     // Data files with valid content
+    bool foundFebFile = true;   // Found matching tester FEB file
+    bool logExists = false;     // Main log file exists
+    std::vector<std::pair<std::string, std::string>> dataTesterPairs;  // Data file -> matched tester ("" if none)
+    
+    // Trim/Conn files specific counters
+    int electronCount = 0;      // Electron files found
+    int holeCount = 0;          // Hole files found
+    
+    // Pscan files specific counters
+    int electronTxtCount = 0;   // Electron text files
+    int holeTxtCount = 0;       // Hole text files
+    int electronRootCount = 0;  // Electron root files
+    int holeRootCount = 0;      // Hole root files
+
+    // Results are moved from the validators into the global state, never copied
+    ValidationResult() = default;
+    ValidationResult(ValidationResult&&) = default;
+    ValidationResult& operator=(ValidationResult&&) = default;
+    ValidationResult(const ValidationResult&) = delete;
+    ValidationResult& operator=(const ValidationResult&) = delete;
+};
+
+/*
+ * DirectoryValidation Structure:
+ * Results of all four validators for a single test directory
+ */
+struct DirectoryValidation {
+    TString dirName;                // Name of the validated directory
+    ValidationResult logResult;     // CheckLogFiles findings
+    ValidationResult trimResult;    // CheckTrimFiles findings
+    ValidationResult pscanResult;   // CheckPscanFiles findings
+    ValidationResult connResult;    // CheckConnFiles findings
+
+    DirectoryValidation() = default;
+    DirectoryValidation(DirectoryValidation&&) = default;
+    DirectoryValidation& operator=(DirectoryValidation&&) = default;
+    DirectoryValidation(const DirectoryValidation&) = delete;
+    DirectoryValidation& operator=(const DirectoryValidation&) = delete;
+};
+
+class ResultStream;  // Streaming JSON/CSV writer (Reporting Functions)
+class ValidationJournal;  // Checkpoint of a validation pass (Checkpoint Journal)
+
+/*
+ * GlobalState Structure:
+ * Tracks overall validation state across all directories
+ */
+struct GlobalState {
+    std::vector<std::string> reportPages;   // Individual directory reports
+    std::vector<DirectoryValidation> results;  // Per-directory validation results (result cache)
+    std::string globalSummary;              // Consolidated summary
+    int goodDirs = 0;                       // Count of good quality directories
+    int auxDirs = 0;                        // Count of directories with auxiliary files
+    int missextraDirs = 0;                  // Count of directories with missing/extra files 
+    int errorDirs = 0;                      // Count of directories ith access errors
+    std::string currentLadder;             // Current working directory name
+    std::shared_ptr<ResultStream> stream;  // Per-directory JSON/CSV output (nullptr = off)
+    std::shared_ptr<ValidationJournal> journal;  // Checkpoint of recorded directories (nullptr = off)
+};
+
+GlobalState gState;  // Global state instance
+std::mutex gStateMutex;  // Guards merges into gState (or a batch ladder's state)
+
+/*
+ * ExorcismOptions Structure:
+ * Run-time configuration, parsed from the option string given to Exorcism()
+ */
+struct ExorcismOptions {
+    int workers = 1;  // Validation worker threads (1 = sequential, 0 = one per core)
+    bool deepRootCheck = false;  // Validate ROOT files with TFile::Open instead of the header check
+    bool useCache = true;      // Reuse verdicts from the ladder's validation cache
+    std::string cacheFile;     // Cache location ("" = <ladder>/.exorcism_cache)
+    int formats = FORMAT_DEFAULT;  // Report output formats (FORMAT_* mask)
+    std::vector<std::string> batchRoots;  // Batch mode: folders containing ladder folders
+    int cleanupMode = CLEANUP_INTERACTIVE;  // CLEANUP_* value
+    int cleanupPolicy = POLICY_ASK;         // POLICY_* value (interactive mode)
+    std::string manifestFile;  // Cleanup manifest ("" = <ladder>/ExorcismCleanup_<ladder>.tsv)
+    int deleteWorkers = 4;     // Concurrent deletions during cleanup (0 = one per core)
+    bool quarantine = false;   // Move files into a quarantine folder instead of deleting them
+    bool purgeQuarantine = false;  // Delete quarantine folders of earlier runs
+    bool pdfSummaryOnly = false;   // PDF: summary page and directory index only
+    bool watch = false;            // Keep validating changes until interrupted
+    int watchSettleMs = 2000;      // Quiet time before changed directories are re-checked
+    bool verdictOnly = false;      // Status codes only: validators stop once the status is final
+    int verbosity = VERBOSITY_NORMAL;  // VERBOSITY_* level of the validator console output
+    bool discoverAll = false;      // Validate every folder, also those without a test-run structure
+    std::vector<std::string> includeGlobs;  // Only test directories matching one of these ("" = all)
+    std::vector<std::string> excludeGlobs;  // Never test directories matching one of these
+    bool diff = false;             // Write a delta report against an earlier ROOT report
+    std::string diffBase;          // That report ("" = the newest *_before.root of the ladder)
+    bool journal = true;           // Checkpoint the first pass to <ladder>/.exorcism_journal
+    bool resume = false;           // Take unchanged directories from the journal of an interrupted run
+    int shardIndex = 0;            // Batch mode: this job's shard (0..shardCount-1)
+    int shardCount = 1;            // Batch mode: number of shards the ladders are split into
+    std::vector<std::string> shardResults;  // Shard result files (or folders) to merge
+};
+
+ExorcismOptions gOptions;  // Global options instance
+
+/*
+ * FileEntry Structure:
+ * Metadata of a single directory entry, gathered once per scan
+ */
+struct FileEntry {
+    std::string name;           // Entry name (without path)
+    Long64_t size = 0;          // File size in bytes
+    Long64_t mtime = 0;         // Last modification time in ns (same-second rewrites differ)
+    ULong_t inode = 0;          // Inode number
+    bool isDirectory = false;   // Entry is a directory
+    bool statOk = false;        // Metadata could be read
+};
+
+/*
+ * DirectorySnapshot Structure:
+ * In-memory listing of a directory built by a single readdir/stat sweep.
+ * Entries keep the on-disk listing order.
+ */
+struct DirectorySnapshot {
+    bool exists = false;             // Path exists
+    bool readable = false;           // Directory contents could be listed
+    std::vector<FileEntry> entries;  // All entries except "." and ".."
+
+    const FileEntry* Find(const std::string& name) const {
+        for (const auto& entry : entries) {
+            if (entry.name == name) return &entry;
+        }
+        return nullptr;
+    }
+};
+
+std::map<std::string, DirectorySnapshot> gSnapshots;  // Snapshots keyed by full directory path
+std::mutex gSnapshotsMutex;  // Guards insertions into gSnapshots
+
+// ===================================================================
+// Instrumentation
+// ===================================================================
+
+/*
+ * Instrumented Stages:
+ * Parts of a run whose time and I/O are accounted separately
+ */
+#define STAGE_DISCOVERY      0   // FindValidationDirectories
+#define STAGE_LOG            1   // CheckLogFiles
+#define STAGE_MATCHING       2   // Data/tester file matching in CheckLogFiles
+#define STAGE_TRIM           3   // CheckTrimFiles
+#define STAGE_PSCAN          4   // CheckPscanFiles
+#define STAGE_CONN           5   // CheckConnFiles
+#define STAGE_REPORT_TXT     6   // SaveTxtReport
+#define STAGE_REPORT_ROOT    7   // SaveRootReport
+#define STAGE_REPORT_PDF     8   // PDF rendering (PDF thread)
+#define STAGE_REPORT_STREAM  9   // JSON/CSV records
+#define STAGE_CLEANUP       10   // Extra_Omnes and the deletions
+#define STAGE_PROMPT        11   // Waiting for cleanup confirmations
+#define STAGE_COUNT         12
+
+#define PROFILE_SLOWEST_FILES 10  // Length of the slowest-files list
+
+const char* const kStageNames[STAGE_COUNT] = {
+    "discovery", "log", "matching", "trim", "pscan", "conn",
+    "report-txt", "report-root", "report-pdf", "report-stream", "cleanup", "prompt"
+};
+
+/*
+ * StageCounters Structure:
+ * Accumulated cost of one stage. Times add up over all threads; files
+ * are content checks actually run (cache misses), reports written or
+ * cleanup actions; ioCalls count the file system library calls made
+ * directly (open, fstat, each readdir(), ...), not kernel system calls.
+ */
+struct StageCounters {
+    std::atomic<Long64_t> calls{0};     // Times the stage was entered
+    std::atomic<Long64_t> wallNs{0};    // Exclusive time, nested stages excluded
+    std::atomic<Long64_t> files{0};     // Files processed
+    std::atomic<Long64_t> bytes{0};     // Bytes read
+    std::atomic<Long64_t> ioCalls{0};   // open/stat/readdir/read/... calls
+};
+
+/*
+ * SlowFile Structure:
+ * One entry of the slowest-files list
+ */
+struct SlowFile {
+    double seconds = 0;     // Time of the content check
+    std::string stage;      // Stage that checked the file
+    std::string path;       // Full file path
+};
+
+/*
+ * RunProfile Structure:
+ * Instrumentation of the current run
+ */
+struct RunProfile {
+    StageCounters stages[STAGE_COUNT];
+    std::vector<SlowFile> slowest;     // Slowest content checks, slowest first
+    std::mutex slowestMutex;           // Guards slowest
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    void Reset() {
+        for (auto& stage : stages) {
+            stage.calls = 0;
+            stage.wallNs = 0;
+            stage.files = 0;
+            stage.bytes = 0;
+            stage.ioCalls = 0;
+        }
+        std::lock_guard<std::mutex> lock(slowestMutex);
+        slowest.clear();
+        start = std::chrono::steady_clock::now();
+    }
+};
+
+RunProfile gProfile;  // Global instrumentation instance
+
+/*
+ * ScopedStage:
+ * Accounts the lifetime of the object to a stage on the calling thread.
+ * A nested stage pauses the enclosing one, so every stage reports its
+ * exclusive time (e.g. cleanup without the time spent at the prompt).
+ */
+class ScopedStage {
+public:
+    explicit ScopedStage(int stageIndex) : stage(stageIndex), parent(tCurrent) {
+        if (parent) parent->Pause();
+        tCurrent = this;
+        gProfile.stages[stage].calls++;
+        started = std::chrono::steady_clock::now();
+    }
+
+    ~ScopedStage() {
+        Pause();
+        tCurrent = parent;
+        if (parent) parent->started = std::chrono::steady_clock::now();
+    }
+
+    // Stage the calling thread is in, -1 outside all stages
+    static int Current() { return tCurrent ? tCurrent->stage : -1; }
+
+private:
+    void Pause() {
+        auto elapsed = std::chrono::steady_clock::now() - started;
+        gProfile.stages[stage].wallNs += std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    }
+
+    int stage;                              // STAGE_* index
+    ScopedStage* parent;                    // Enclosing stage on this thread
+    std::chrono::steady_clock::time_point started;  // Start of the running interval
+    static thread_local ScopedStage* tCurrent;      // Innermost stage of this thread
+};
+
+thread_local ScopedStage* ScopedStage::tCurrent = nullptr;
+
+/*
+ * CountIo:
+ * Adds file system calls and bytes read to the calling thread's current stage
+ */
+void CountIo(Long64_t ioCalls, Long64_t bytes = 0) {
+    int stage = ScopedStage::Current();
+    if (stage < 0) return;
+    gProfile.stages[stage].ioCalls += ioCalls;
+    gProfile.stages[stage].bytes += bytes;
+}
+
+/*
+ * CountFile:
+ * Adds one processed file to the calling thread's current stage
+ */
+void CountFile() {
+    int stage = ScopedStage::Current();
+    if (stage >= 0) gProfile.stages[stage].files++;
+}
+
+/*
+ * RecordFileTime:
+ * Enters a file check into the slowest-files list if it qualifies
+ */
+void RecordFileTime(const TString& path, double seconds) {
+    std::lock_guard<std::mutex> lock(gProfile.slowestMutex);
+    std::vector<SlowFile>& slowest = gProfile.slowest;
+    if (slowest.size() >= PROFILE_SLOWEST_FILES && seconds <= slowest.back().seconds) return;
+
+    SlowFile entry;
+    entry.seconds = seconds;
+    int stage = ScopedStage::Current();
+    entry.stage = stage >= 0 ? kStageNames[stage] : "";
+    entry.path = path.Data();
+    auto pos = std::upper_bound(slowest.begin(), slowest.end(), entry,
+                                [](const SlowFile& a, const SlowFile& b) { return a.seconds > b.seconds; });
+    slowest.insert(pos, entry);
+    if (slowest.size() > PROFILE_SLOWEST_FILES) slowest.pop_back();
+}
+
+/*
+ * PrintProfile:
+ * Prints the stage table and the slowest files of the run
+ */
+void PrintProfile() {
+    double runSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - gProfile.start).count();
+
+    std::cout << "\n===== PERFORMANCE PROFILE =====" << std::endl;
+    std::cout << TString::Format("%-14s %8s %10s %8s %12s %10s", "Stage", "Calls", "Time [s]",
+                                 "Files", "Bytes read", "I/O calls") << std::endl;
+    for (int i = 0; i < STAGE_COUNT; i++) {
+        const StageCounters& stage = gProfile.stages[i];
+        if (stage.calls == 0) continue;
+        std::cout << TString::Format("%-14s %8lld %10.3f %8lld %12lld %10lld", kStageNames[i],
+                                     (long long)stage.calls, stage.wallNs * 1e-9, (long long)stage.files,
+                                     (long long)stage.bytes, (long long)stage.ioCalls) << std::endl;
+    }
+    std::cout << "Run wall time: " << TString::Format("%.3f", runSeconds)
+              << " s (stage times are summed over worker threads)" << std::endl;
+
+    std::lock_guard<std::mutex> lock(gProfile.slowestMutex);
+    if (!gProfile.slowest.empty()) {
+        std::cout << "Slowest file checks:" << std::endl;
+        for (const auto& file : gProfile.slowest) {
+            std::cout << TString::Format("  %8.4f s  %-6s %s", file.seconds, file.stage.c_str(),
+                                         file.path.c_str()) << std::endl;
+        }
+    }
+}
+
+// ===================================================================
+// Helper Functions
+// ===================================================================
+
+/*
+ * Console Output Streams:
+ * Validators write through Out()/Err(). Inside a captured check these
+ * point to per-task buffers, which are printed in a fixed order afterwards.
+ * Trace() carries per-file chatter and discards it below VERBOSITY_VERBOSE.
+ */
+thread_local std::ostringstream* tOutBuffer = nullptr;
+thread_local std::ostringstream* tErrBuffer = nullptr;
+
+std::ostream& Out() {
+    if (tOutBuffer) return *tOutBuffer;
+    return std::cout;
+}
+
+std::ostream& Err() {
+    if (tErrBuffer) return *tErrBuffer;
+    return std::cerr;
+}
+
+std::ostream& Trace() {
+    thread_local std::ostream discard(nullptr);  // No buffer: every insertion is a no-op
+    if (gOptions.verbosity >= VERBOSITY_VERBOSE) return Err();
+    return discard;
+}
+
+/*
+ * FormatCurrentTime:
+ * Formats the local time of the run with strftime
+ */
+std::string FormatCurrentTime(const char* format) {
+    time_t now = time(nullptr);
+    struct tm localTime;
+    localtime_r(&now, &localTime);
+    char buffer[64];
+    size_t length = strftime(buffer, sizeof(buffer), format, &localTime);
+    return std::string(buffer, length);
+}
+
+/*
+ * StableHash:
+ * 64-bit FNV-1a with a final avalanche step. Unlike std::hash it is the
+ * same in every build, so all nodes of a sharded run agree on it and
+ * journal fingerprints stay valid across runs.
+ */
+ULong64_t StableHash(std::string_view text, ULong64_t seed = 0) {
+    ULong64_t hash = 14695981039346656037ULL ^ seed;
+    for (unsigned char c : text) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+/*
+ * DirectoryExists:
+ * Checks if a directory exists at the given path
+ */
+bool DirectoryExists(const TString& path) {
+    return !gSystem->AccessPathName(path, kFileExists);
+}
+
+/*
+ * FileNameOf:
+ * Name part of a path, as a view into the path (no copy)
+ */
+std::string_view FileNameOf(const TString& filePath) {
+    std::string_view path(filePath.Data(), filePath.Length());
+    size_t slash = path.rfind('/');
+    return slash == std::string_view::npos ? path : path.substr(slash + 1);
+}
+
+/*
+ * FileProbe Structure:
+ * Existence, size and readability of one file
+ */
+struct FileProbe {
+    bool exists = false;    // File is listed in its directory snapshot
+    bool readable = false;  // File can be opened for reading
+    Long64_t size = 0;      // Size in bytes
+};
+
+/*
+ * ProbeFile:
+ * Probes a file listed in a directory snapshot (entry = nullptr: not
+ * listed). The size comes from the snapshot's stat, readability from a
+ * single access() call; only entries whose stat failed are opened.
+ */
+FileProbe ProbeFile(const TString& filePath, const FileEntry* entry) {
+    FileProbe probe;
+    if (!entry) return probe;
+    probe.exists = true;
+
+    if (entry->statOk) {
+        probe.size = entry->size;
+        probe.readable = (access(filePath.Data(), R_OK) == 0);
+        CountIo(1);
+        return probe;
+    }
+
+    int fd = open(filePath.Data(), O_RDONLY);
+    CountIo(fd >= 0 ? 3 : 1);  // open, fstat, close
+    struct stat st;
+    if (fd >= 0 && fstat(fd, &st) == 0) {
+        probe.readable = true;
+        probe.size = st.st_size;
+    }
+    if (fd >= 0) close(fd);
+    return probe;
+}
+
+/*
+ * CheckFileAccess:
+ * Verifies if a listed file can be opened and tracks failures
+ */
+bool CheckFileAccess(const TString& filePath, const FileEntry* entry, NameList& errorList) {
+    if (!ProbeFile(filePath, entry).readable) {
+        errorList.push_back(FileNameOf(filePath));
+        return false;
+    }
+    return true;
+}
+
+/*
+ * RootFileOpens:
+ * Returns true if a ROOT file can be opened and is not a zombie
+ */
+bool RootFileOpens(const TString& filePath) {
+    TFile* file = TFile::Open(filePath, "READ");
+    bool isValid = (file && !file->IsZombie());
+    if (file) CountIo(2 + file->GetReadCalls(), file->GetBytesRead());  // open + reads + close
+    delete file;
+    return isValid;
+}
+
+/*
+ * ReadBigEndian:
+ * Decodes an unsigned big-endian integer of nBytes bytes (ROOT on-disk byte order)
+ */
+ULong64_t ReadBigEndian(const unsigned char* buffer, int nBytes) {
+    ULong64_t value = 0;
+    for (int i = 0; i < nBytes; i++) {
+        value = (value << 8) | buffer[i];
+    }
+    return value;
+}
+
+/*
+ * RootHeaderIsValid:
+ * Fast ROOT file integrity check. Reads only the fixed file header and the
+ * top directory record with pread(), without the ROOT I/O machinery.
+ *
+ * Checks:
+ * 1. "root" magic at the start of the file
+ * 2. Plausible fBEGIN/fNbytesName
+ * 3. fEND does not exceed the actual file size (truncated files fail)
+ * 4. The keys list (fSeekKeys, fNbytesKeys) lies inside [fBEGIN, fEND]
+ *
+ * Files that TFile::Open would only accept after recovery (not properly
+ * closed) fail this check.
+ */
+bool RootHeaderIsValid(const char* filePath) {
+    int fd = open(filePath, O_RDONLY);
+    if (fd < 0) {
+        CountIo(1);
+        return false;
+    }
+
+    struct stat st;
+    unsigned char header[64];
+    bool isValid = (fstat(fd, &st) == 0 &&
+                    pread(fd, header, sizeof(header), 0) == (ssize_t)sizeof(header) &&
+                    memcmp(header, "root", 4) == 0);
+    CountIo(4, sizeof(header));  // open, fstat, pread, close
+
+    Long64_t begin = 0, end = 0, nbytesName = 0;
+    if (isValid) {
+        Long64_t fileSize = st.st_size;  // st is only filled when fstat succeeded
+        // Version >= 1000000 marks a large file with 64-bit seek pointers
+        Long64_t version = (Int_t)ReadBigEndian(header + 4, 4);
+        begin = (Int_t)ReadBigEndian(header + 8, 4);
+        if (version < 1000000) {
+            end = (Int_t)ReadBigEndian(header + 12, 4);
+            nbytesName = (Int_t)ReadBigEndian(header + 28, 4);
+        } else {
+            end = (Long64_t)ReadBigEndian(header + 12, 8);
+            nbytesName = (Int_t)ReadBigEndian(header + 36, 4);
+        }
+        isValid = (version > 0 && begin > 0 && nbytesName > 0 &&
+                   end > begin && end <= fileSize);
+    }
+
+    // Top directory record: version, 2 x TDatime, fNbytesKeys, fNbytesName, 3 seek pointers
+    if (isValid) {
+        unsigned char dirRecord[42];
+        ssize_t nRead = pread(fd, dirRecord, sizeof(dirRecord), begin + nbytesName);
+        CountIo(1, std::max<ssize_t>(nRead, 0));
+        isValid = (nRead >= 30);
+        if (isValid) {
+            int dirVersion = (int)ReadBigEndian(dirRecord, 2);
+            Long64_t nbytesKeys = (Int_t)ReadBigEndian(dirRecord + 10, 4);
+            Long64_t seekKeys = (dirVersion > 1000) ?
+                ((nRead >= 42) ? (Long64_t)ReadBigEndian(dirRecord + 34, 8) : -1) :
+                (Int_t)ReadBigEndian(dirRecord + 26, 4);
+            isValid = (seekKeys > begin && nbytesKeys > 0 && seekKeys + nbytesKeys <= end);
+        }
+    }
+
+    close(fd);
+    return isValid;
+}
+
+/*
+ * RootFileIsValid:
+ * Validates a ROOT file with the configured method
+ * (header check by default, full TFile::Open with --root-check=deep)
+ */
+bool RootFileIsValid(const TString& filePath) {
+    if (gOptions.deepRootCheck) return RootFileOpens(filePath);
+    return RootHeaderIsValid(filePath.Data());
+}
+
+/*
+ * Read-ahead window of the header check: the file header and the top
+ * directory record, which ROOT writes right after it
+ */
+#define ROOT_PREFETCH_BYTES      4096
+
+/*
+ * PrefetchRootFile:
+ * Asks the kernel to start reading the part of a ROOT file that
+ * RootFileIsValid will read (posix_fadvise WILLNEED), without waiting
+ * for it. The header check reads the start of the file; TFile::Open also
+ * reads the keys near the end, so the deep check prefetches everything.
+ */
+void PrefetchRootFile(const TString& filePath) {
+#ifdef POSIX_FADV_WILLNEED
+    int fd = open(filePath.Data(), O_RDONLY);
+    if (fd < 0) {
+        CountIo(1);
+        return;
+    }
+    posix_fadvise(fd, 0, gOptions.deepRootCheck ? 0 : ROOT_PREFETCH_BYTES, POSIX_FADV_WILLNEED);
+    close(fd);
+    CountIo(3);  // open, fadvise, close
+#endif
+}
+
+/*
+ * RootCheckName:
+ * Cache key of the configured ROOT check, so verdicts of the two
+ * methods are never mixed up
+ */
+const char* RootCheckName() {
+    return gOptions.deepRootCheck ? "root-deep" : "root";
+}
+
+/*
+ * CheckRootFile:
+ * Verifies if a ROOT file can be opened properly
+ */
+bool CheckRootFile(const TString& filePath, NameList& errorList) {
+    if (!RootFileIsValid(filePath)) {
+        errorList.push_back(FileNameOf(filePath));
+        return false;
+    }
+    return true;
+}
+
+/*
+ * Read window of the .dat content check: files are read in chunks of
+ * this size until the verdict is known, and the per-thread buffer never
+ * grows beyond one window
+ */
+#define DATA_SCAN_WINDOW         (64 * 1024)
+
+/*
+ * DataContentScan:
+ * State of the .dat content check between read windows
+ */
+struct DataContentScan {
+    static constexpr const char marker[] = "LV_AFT_CONFIG_P";
+    static constexpr size_t markerLength = sizeof(marker) - 1;
+
+    enum Phase { FIND_MARKER, SKIP_MARKER_LINE, COUNT_LINES };
+    Phase phase = FIND_MARKER;
+    int validLinesAfter = 0;   // Non-blank lines after the marker line
+    bool lineCounted = false;  // Current line already counted as non-blank
+
+    /*
+     * Feed:
+     * Scans the next window. In FIND_MARKER the caller keeps the
+     * returned number of trailing bytes in front of the next window,
+     * so a marker split across two windows is still found.
+     *
+     * Returns:
+     *   Trailing bytes to carry over (0 outside FIND_MARKER)
+     */
+    size_t Feed(const char* data, size_t size) {
+        const char* end = data + size;
+        const char* pos = data;
+        if (phase == FIND_MARKER) {
+            const char* markerPos = static_cast<const char*>(memmem(pos, end - pos, marker, markerLength));
+            if (!markerPos) return std::min(size, markerLength - 1);
+            pos = markerPos + markerLength;
+            phase = SKIP_MARKER_LINE;
+        }
+        if (phase == SKIP_MARKER_LINE) {
+            const char* lineEnd = static_cast<const char*>(memchr(pos, '\n', end - pos));
+            if (!lineEnd) return 0;
+            pos = lineEnd + 1;
+            phase = COUNT_LINES;
+        }
+        while (pos < end && !Valid()) {
+            if (lineCounted) {
+                const char* lineEnd = static_cast<const char*>(memchr(pos, '\n', end - pos));
+                if (!lineEnd) break;
+                pos = lineEnd + 1;
+                lineCounted = false;
+            } else if (*pos == '\n' || *pos == ' ' || *pos == '\t') {
+                pos++;
+            } else {
+                validLinesAfter++;
+                lineCounted = true;
+            }
+        }
+        return 0;
+    }
+
+    bool Valid() const { return validLinesAfter >= 2; }
+};
+
+/*
+ * CheckDataFileContent:
+ * Verifies if the content of a .dat file meets expected patterns: the
+ * LV_AFT_CONFIG_P marker line followed by at least two non-blank lines
+ * (blank = only spaces and tabs). The file is read with pread() one
+ * window at a time and reading stops once two such lines were seen. A
+ * file truncated or rewritten while it is read only gives a short read
+ * (unlike a memory mapping, which raises SIGBUS on pages past the new end).
+ * Marker and line ends are located with memmem/memchr, which glibc
+ * implements with vector instructions.
+ */
+bool CheckDataFileContent(const char* filePath) {
+    thread_local std::vector<char> buffer(DATA_SCAN_WINDOW + DataContentScan::markerLength);
+    int fd = open(filePath, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        CountIo(1);
+        return false;
+    }
+
+    DataContentScan scan;
+    Long64_t offset = 0;
+    Long64_t calls = 2;  // open, close
+    size_t carry = 0;
+    bool readError = false;
+    while (!scan.Valid()) {
+        ssize_t nRead = pread(fd, buffer.data() + carry, DATA_SCAN_WINDOW, offset);
+        calls++;
+        if (nRead < 0 && errno == EINTR) continue;
+        if (nRead <= 0) {
+            readError = (nRead < 0);
+            break;
+        }
+        offset += nRead;
+        size_t size = carry + nRead;
+        carry = scan.Feed(buffer.data(), size);
+        if (carry > 0) memmove(buffer.data(), buffer.data() + size - carry, carry);
+    }
+    close(fd);
+    CountIo(calls, offset);
+    return !readError && scan.Valid();
+}
+
+// ===================================================================
+// Directory Snapshot Functions
+// ===================================================================
+
+/*
+ * StatEntry:
+ * Fills size, type and modification time of an entry from stat()
+ */
+void StatEntry(const std::string& fullPath, FileEntry& entry) {
+    struct stat st;
+    entry.statOk = (stat(fullPath.c_str(), &st) == 0);
+    CountIo(1);
+    if (entry.statOk) {
+        entry.size = st.st_size;
+        entry.mtime = (Long64_t)st.st_mtim.tv_sec * 1000000000LL + st.st_mtim.tv_nsec;
+        entry.inode = st.st_ino;
+        entry.isDirectory = S_ISDIR(st.st_mode);
+    }
+}
+
+/*
+ * ScanDirectory:
+ * Lists a directory and stats every entry in one sweep
+ */
+DirectorySnapshot ScanDirectory(const std::string& path) {
+    DirectorySnapshot snapshot;
+    struct stat st;
+    snapshot.exists = (stat(path.c_str(), &st) == 0);
+    CountIo(1);
+    if (!snapshot.exists) return snapshot;
+
+    DIR* dir = opendir(path.c_str());
+    CountIo(dir ? 3 : 1);  // opendir, final readdir, closedir
+    if (!dir) return snapshot;
+    snapshot.readable = true;
+
+    while (struct dirent* ent = readdir(dir)) {
+        CountIo(1);
+        FileEntry entry;
+        entry.name = ent->d_name;
+        if (entry.name == "." || entry.name == "..") continue;
+        StatEntry(path + "/" + entry.name, entry);
+        snapshot.entries.push_back(entry);
+    }
+    closedir(dir);
+    return snapshot;
+}
+
+/*
+ * GetDirectorySnapshot:
+ * Returns the cached snapshot of a directory, scanning it on first use
+ */
+const DirectorySnapshot& GetDirectorySnapshot(const TString& path) {
+    {
+        std::lock_guard<std::mutex> lock(gSnapshotsMutex);
+        auto it = gSnapshots.find(path.Data());
+        if (it != gSnapshots.end()) return it->second;
+    }
+
+    // Scan outside the lock so workers can list different directories at once
+    DirectorySnapshot snapshot = ScanDirectory(path.Data());
+    std::lock_guard<std::mutex> lock(gSnapshotsMutex);
+    return gSnapshots.emplace(path.Data(), std::move(snapshot)).first->second;
+}
+
+/*
+ * RefreshSnapshotEntry:
+ * Re-reads a single entry of a cached snapshot after it was modified
+ * (drops the entry if the file no longer exists)
+ */
+void RefreshSnapshotEntry(const TString& dirPath, const std::string& fileName) {
+    FileEntry updated;
+    updated.name = fileName;
+    StatEntry(std::string(dirPath.Data()) + "/" + fileName, updated);  // Outside the lock
+
+    std::lock_guard<std::mutex> lock(gSnapshotsMutex);
+    auto it = gSnapshots.find(dirPath.Data());
+    if (it == gSnapshots.end()) return;
+
+    std::vector<FileEntry>& entries = it->second.entries;
+    for (size_t i = 0; i < entries.size(); i++) {
+        if (entries[i].name != fileName) continue;
+        if (updated.statOk) {
+            entries[i] = updated;
+        } else {
+            entries.erase(entries.begin() + i);
+        }
+        return;
+    }
+}
+
+/*
+ * ForgetDirectorySnapshots:
+ * Drops the cached snapshots of a directory and of everything below it,
+ * so they are listed again on next use. Only call while no validator runs.
+ */
+void ForgetDirectorySnapshots(const TString& path) {
+    std::string prefix = std::string(path.Data()) + "/";
+    std::lock_guard<std::mutex> lock(gSnapshotsMutex);
+    gSnapshots.erase(path.Data());
+    for (auto it = gSnapshots.lower_bound(prefix);
+         it != gSnapshots.end() && it->first.compare(0, prefix.size(), prefix) == 0; ) {
+        it = gSnapshots.erase(it);
+    }
+}
+
+/*
+ * RemoveFile:
+ * Deletes a file and refreshes its snapshot entry.
+ * Returns true on success (gSystem->Unlink returns 0 on success).
+ */
+bool RemoveFile(const TString& dirPath, const std::string& fileName) {
+    TString filePath = dirPath + "/" + fileName.c_str();
+    bool removed = (gSystem->Unlink(filePath.Data()) == 0);
+    CountIo(1);
+    RefreshSnapshotEntry(dirPath, fileName);
+    return removed;
+}
+
+/*
+ * MakeDirectories:
+ * Creates a directory and its missing parents (like mkdir -p).
+ * Safe to call concurrently for overlapping paths.
+ */
+bool MakeDirectories(const std::string& path) {
+    for (size_t pos = path.find('/', 1); ; pos = path.find('/', pos + 1)) {
+        std::string part = path.substr(0, pos);
+        CountIo(1);
+        if (mkdir(part.c_str(), 0755) != 0 && errno != EEXIST) return false;
+        if (pos == std::string::npos) return true;
+    }
+}
+
+/*
+ * QuarantineFile:
+ * Moves a file into quarantineDir/relativeDir instead of deleting it (one
+ * rename on the same filesystem, reversible) and refreshes its snapshot entry
+ */
+bool QuarantineFile(const TString& dirPath, const std::string& fileName,
+                    const std::string& quarantineDir, const std::string& relativeDir) {
+    std::string targetDir = quarantineDir + "/" + relativeDir;
+    std::string source = std::string(dirPath.Data()) + "/" + fileName;
+    bool moved = MakeDirectories(targetDir) &&
+                 rename(source.c_str(), (targetDir + "/" + fileName).c_str()) == 0;
+    CountIo(1);
+    RefreshSnapshotEntry(dirPath, fileName);
+    return moved;
+}
+
+/*
+ * RemoveTree:
+ * Recursively deletes a directory without following symbolic links
+ *
+ * Returns:
+ *   true if everything was removed
+ */
+bool RemoveTree(const std::string& path) {
+    DIR* dir = opendir(path.c_str());
+    if (!dir) return false;
+
+    bool removedAll = true;
+    while (struct dirent* entry = readdir(dir)) {
+        std::string name = entry->d_name;
+        if (name == "." || name == "..") continue;
+
+        std::string child = path + "/" + name;
+        struct stat st;
+        if (lstat(child.c_str(), &st) == 0 && S_ISDIR(st.st_mode)) {
+            removedAll &= RemoveTree(child);
+        } else {
+            removedAll &= (unlink(child.c_str()) == 0);
+        }
+    }
+    closedir(dir);
+    return (rmdir(path.c_str()) == 0) && removedAll;
+}
+
+// ===================================================================
+// Validation Cache
+// ===================================================================
+/*
+ * The validation cache is a sidecar file in the ladder directory that
+ * stores the verdict of the expensive per-file checks (ROOT file opening,
+ * .dat content parsing). A verdict is reused only while the file's size,
+ * modification time and inode are unchanged.
+ *
+ * File format (one verdict per line, tab separated):
+ *   <check> <size> <mtime in ns> <inode> <passed 0/1> <full path>
+ */
+#define VALIDATION_CACHE_HEADER "# EXORCISM validation cache v2"
+
+/*
+ * CachedVerdict Structure:
+ * Stored outcome of one per-file check
+ */
+struct CachedVerdict {
+    Long64_t size = 0;      // File size when checked
+    Long64_t mtime = 0;     // Modification time (ns) when checked
+    ULong_t inode = 0;      // Inode when checked
+    bool passed = false;    // Check outcome
+    bool used = false;      // Looked up or stored during this run
+};
+
+/*
+ * ValidationCache Structure:
+ * In-memory copy of the sidecar cache file
+ */
+struct ValidationCache {
+    std::string filePath;                           // Sidecar location ("" = disabled)
+    std::map<std::string, CachedVerdict> verdicts;  // "<check>\t<full path>" -> verdict
+    std::mutex mutex;                               // Guards verdicts and counters
+    int hits = 0;                                   // Verdicts reused this run
+    int misses = 0;                                 // Checks actually executed this run
+};
+
+ValidationCache gCache;  // Global validation cache
+
+/*
+ * LoadValidationCache:
+ * Reads the sidecar cache file (a missing file just starts an empty cache)
+ */
+void LoadValidationCache(const std::string& filePath) {
+    std::lock_guard<std::mutex> lock(gCache.mutex);
+    gCache.filePath = filePath;
+    gCache.verdicts.clear();
+    gCache.hits = 0;
+    gCache.misses = 0;
+
+    std::ifstream in(filePath.c_str());
+    if (!in.is_open()) return;
+
+    std::string line;
+    if (!std::getline(in, line) || line != VALIDATION_CACHE_HEADER) {
+        std::cerr << "Warning: Ignoring validation cache with unknown format: " << filePath << std::endl;
+        return;
+    }
+
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        std::string check, path;
+        CachedVerdict verdict;
+        int passed = 0;
+        if (!std::getline(fields, check, '\t')) continue;
+        if (!(fields >> verdict.size >> verdict.mtime >> verdict.inode >> passed)) continue;
+        fields.ignore(1);  // Tab before the path
+        if (!std::getline(fields, path) || path.empty()) continue;
+        verdict.passed = (passed != 0);
+        gCache.verdicts[check + "\t" + path] = verdict;
+    }
+}
+
+/*
+ * SaveValidationCache:
+ * Writes the verdicts back to the sidecar file. Verdicts not looked up
+ * during this run (directories left out by --include/--exclude, checks
+ * skipped in verdict-only mode, resumed directories) are kept while their
+ * file is unchanged; those of deleted or modified files are dropped.
+ */
+void SaveValidationCache() {
+    std::lock_guard<std::mutex> lock(gCache.mutex);
+    if (gCache.filePath.empty()) return;
+
+    // Write to a temporary file first so an interrupted save keeps the old cache
+    std::string tmpPath = gCache.filePath + ".tmp";
+    std::ofstream out(tmpPath.c_str());
+    if (!out.is_open()) {
+        std::cerr << "Warning: Could not write validation cache: " << tmpPath << std::endl;
+        return;
+    }
+
+    out << VALIDATION_CACHE_HEADER << "\n";
+    for (const auto& item : gCache.verdicts) {
+        const CachedVerdict& verdict = item.second;
+        size_t tabPos = item.first.find('\t');
+        if (!verdict.used) {
+            FileEntry entry;
+            StatEntry(item.first.substr(tabPos + 1), entry);
+            if (!entry.statOk || entry.size != verdict.size || entry.mtime != verdict.mtime ||
+                entry.inode != verdict.inode) continue;
+        }
+        out << item.first.substr(0, tabPos) << "\t" << verdict.size << "\t" << verdict.mtime << "\t"
+            << verdict.inode << "\t" << (verdict.passed ? 1 : 0) << "\t" << item.first.substr(tabPos + 1) << "\n";
+    }
+    out.close();
+
+    if (out.fail() || rename(tmpPath.c_str(), gCache.filePath.c_str()) != 0) {
+        std::cerr << "Warning: Could not update validation cache: " << gCache.filePath << std::endl;
+        gSystem->Unlink(tmpPath.c_str());
+    }
+}
+
+/*
+ * OpenValidationCache:
+ * Loads the cache selected by the options: --cache-file, otherwise
+ * .exorcism_cache inside folder (one per shard with --shard, since every
+ * save rewrites the whole file); nothing with --no-cache
+ */
+void OpenValidationCache(const std::string& folder) {
+    if (!gOptions.useCache) {
+        LoadValidationCache("");  // Disabled: nothing is read or stored
+        return;
+    }
+    std::string cacheFile = gOptions.cacheFile;
+    if (cacheFile.empty()) {
+        cacheFile = folder + "/.exorcism_cache";
+        if (gOptions.shardCount > 1) {
+            cacheFile += TString::Format("_shard%dof%d", gOptions.shardIndex, gOptions.shardCount).Data();
+        }
+    }
+    LoadValidationCache(cacheFile);
+}
+
+/*
+ * MarkCachedVerdictsUsed:
+ * Marks the verdicts of all files inside the given test directories of a
+ * ladder as used, for results taken over without running their checks
+ * (so SaveValidationCache keeps them without a stat() each)
+ */
+void MarkCachedVerdictsUsed(const TString& ladderDir, const std::set<std::string>& dirNames) {
+    if (dirNames.empty()) return;
+    std::string prefix = std::string(ladderDir.Data()) + "/";
+    std::lock_guard<std::mutex> lock(gCache.mutex);
+    for (auto& item : gCache.verdicts) {
+        std::string_view path = std::string_view(item.first).substr(item.first.find('\t') + 1);
+        if (!HasPrefix(path, prefix)) continue;
+        std::string_view rest = path.substr(prefix.size());
+        if (dirNames.count(std::string(rest.substr(0, rest.find('/'))))) item.second.used = true;
+    }
+}
+
+/*
+ * HasCachedVerdict:
+ * True if CachedCheck would answer from the cache without running the check
+ */
+bool HasCachedVerdict(const char* check, const TString& filePath, const FileEntry& entry) {
+    if (gCache.filePath.empty() || !entry.statOk) return false;
+    std::string key = std::string(check) + "\t" + filePath.Data();
+    std::lock_guard<std::mutex> lock(gCache.mutex);
+    auto it = gCache.verdicts.find(key);
+    return it != gCache.verdicts.end() && it->second.size == entry.size &&
+           it->second.mtime == entry.mtime && it->second.inode == entry.inode;
+}
+
+/*
+ * CachedCheck:
+ * Returns the cached verdict of a per-file check if the file is unchanged,
+ * otherwise runs the check and stores its outcome.
+ *
+ * Parameters:
+ *   check    - Name of the check (e.g. "root", "data")
+ *   filePath - Full path of the file
+ *   entry    - Snapshot entry of the file (size/mtime/inode key)
+ *   evaluate - Callable performing the actual check
+ */
+template <typename F>
+bool CachedCheck(const char* check, const TString& filePath, const FileEntry& entry, F evaluate) {
+    std::string key = std::string(check) + "\t" + filePath.Data();
+    bool cacheable = !gCache.filePath.empty() && entry.statOk;
+
+    if (cacheable) {
+        std::lock_guard<std::mutex> lock(gCache.mutex);
+        auto it = gCache.verdicts.find(key);
+        if (it != gCache.verdicts.end() && it->second.size == entry.size &&
+            it->second.mtime == entry.mtime && it->second.inode == entry.inode) {
+            it->second.used = true;
+            gCache.hits++;
+            return it->second.passed;
+        }
+    }
+
+    // Run the expensive check without holding the lock
+    auto started = std::chrono::steady_clock::now();
+    bool passed = evaluate();
+    RecordFileTime(filePath, std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count());
+    CountFile();
+
+    if (cacheable) {
+        std::lock_guard<std::mutex> lock(gCache.mutex);
+        CachedVerdict& verdict = gCache.verdicts[key];
+        verdict.size = entry.size;
+        verdict.mtime = entry.mtime;
+        verdict.inode = entry.inode;
+        verdict.passed = passed;
+        verdict.used = true;
+        gCache.misses++;
+    }
+    return passed;
+}
+
+// ===================================================================
+// Thread Pool
+// ===================================================================
+
+/*
+ * ThreadPool:
+ * Fixed set of worker threads consuming a FIFO task queue.
+ * Submit() returns a future for the task result; the destructor
+ * finishes all queued tasks before joining the workers.
+ */
+class ThreadPool {
+public:
+    explicit ThreadPool(int nWorkers) {
+        for (int i = 0; i < nWorkers; i++) {
+            workers.emplace_back([this]() { WorkerLoop(); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            stopping = true;
+        }
+        queueSignal.notify_all();
+        for (auto& worker : workers) worker.join();
+    }
+
+    template <typename F>
+    std::future<std::invoke_result_t<F>> Submit(F task) {
+        using ResultType = std::invoke_result_t<F>;
+        auto packaged = std::make_shared<std::packaged_task<ResultType()>>(std::move(task));
+        std::future<ResultType> future = packaged->get_future();
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            tasks.push([packaged]() { (*packaged)(); });
+        }
+        queueSignal.notify_one();
+        return future;
+    }
+
+private:
+    void WorkerLoop() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(queueMutex);
+                queueSignal.wait(lock, [this]() { return stopping || !tasks.empty(); });
+                if (tasks.empty()) return;  // Stopping and nothing left to do
+                task = std::move(tasks.front());
+                tasks.pop();
+            }
+            task();
+        }
+    }
+
+    std::vector<std::thread> workers;           // Worker threads
+    std::queue<std::function<void()>> tasks;    // Pending tasks
+    std::mutex queueMutex;                      // Guards tasks and stopping
+    std::condition_variable queueSignal;        // Wakes idle workers
+    bool stopping = false;                      // Set when the pool shuts down
+};
+
+/*
+ * ResolveWorkerCount:
+ * Translates the --workers option into an actual thread count
+ */
+int ResolveWorkerCount(int requested) {
+    if (requested > 0) return requested;
+    int cores = (int)std::thread::hardware_concurrency();
+    return cores > 0 ? cores : 1;
+}
+
+// ===================================================================
+// Validation Rules
+// ===================================================================
+
+#define RULE_CHECK_EXISTS        0      // Presence only
+#define RULE_CHECK_TEXT          1      // Must open; empty files are listed
+#define RULE_CHECK_ROOT          2      // Cached ROOT validity check
+
+#define RULE_NONE               -1      // ClassifyFile: no rule matches
+#define RULE_AUX                -2      // ClassifyFile: accepted auxiliary file
+
+#define HW_INDEX_TAG             "_HW_"   // Precedes the HW index in per-HW file names
+#define HW_INDEX_END             "_SET_"  // Follows the HW index in trim file names
+#define MODULE_FILE_PREFIX       "module_test_"  // + test directory or SETUP
+
+/*
+ * HW Index Limits:
+ * MODULE_HW_COUNT is the number of HW (front-end board) files per kind in
+ * every subfolder; build with -DMODULE_HW_COUNT=N for larger modules.
+ * Seen indices are tracked in fixed bitsets of HW_INDEX_MAX bits, one per
+ * rule, so a folder has at most FOLDER_MAX_RULES per-HW file kinds.
+ */
+#ifndef MODULE_HW_COUNT
+#define MODULE_HW_COUNT          8
+#endif
+#define HW_INDEX_MAX             64
+#define FOLDER_MAX_RULES         8
+
+static_assert(MODULE_HW_COUNT > 0 && MODULE_HW_COUNT <= HW_INDEX_MAX, "MODULE_HW_COUNT must be 1..HW_INDEX_MAX");
+
+/*
+ * StatusMasks Structure:
+ * Flags of one validator that raise its directory to each STATUS_* level
+ */
+struct StatusMasks {
+    int check;           // CHECK_* bit of the validator
+    int directoryError;  // STATUS_DIRECTORY_ERROR
+    int missingExtra;    // STATUS_DATA_INCONSISTENT_MISSING_EXTRA
+    int auxiliary;       // STATUS_DATA_INCONSISTENT_AUXILIARY
+};
+
+const StatusMasks kStatusMasks[4] = {
+    {CHECK_LOG, FLAG_DIR_MISSING,
+     FLAG_LOG_MISSING | FLAG_DATA_MISSING | FLAG_NO_FEB_FILE | FLAG_FILE_OPEN | FLAG_DATA_INVALID | FLAG_DATA_EMPTY,
+     FLAG_UNEXPECTED_FILES},
+    {CHECK_TRIM, FLAG_TRIM_FOLDER_MISSING | FLAG_DIR_ACCESS_TRIM,
+     FLAG_FILE_OPEN_TRIM | FLAG_ELECTRON_COUNT_TRIM | FLAG_HOLE_COUNT_TRIM,
+     FLAG_UNEXPECTED_FILES_TRIM},
+    {CHECK_PSCAN, FLAG_PSCAN_FOLDER_MISSING | FLAG_DIR_ACCESS_PSCAN,
+     FLAG_FILE_OPEN_PSCAN | FLAG_ELECTRON_TXT | FLAG_HOLE_TXT | FLAG_ELECTRON_ROOT | FLAG_HOLE_ROOT |
+     FLAG_MODULE_ROOT | FLAG_MODULE_TXT | FLAG_MODULE_PDF,
+     FLAG_UNEXPECTED_FILES_PSCAN},
+    {CHECK_CONN, FLAG_CONN_FOLDER_MISSING | FLAG_DIR_ACCESS,
+     FLAG_FILE_OPEN_CONN | FLAG_ELECTRON_COUNT | FLAG_HOLE_COUNT,
+     FLAG_UNEXPECTED_FILES_CONN}
+};
+
+/*
+ * CheckStatus:
+ * STATUS_* level implied by the flags of one validator (check = CHECK_* bit)
+ */
+int CheckStatus(int check, int flags) {
+    for (const auto& masks : kStatusMasks) {
+        if (masks.check != check) continue;
+        if (flags & masks.directoryError) return STATUS_DIRECTORY_ERROR;
+        if (flags & masks.missingExtra) return STATUS_DATA_INCONSISTENT_MISSING_EXTRA;
+        if (flags & masks.auxiliary) return STATUS_DATA_INCONSISTENT_AUXILIARY;
+    }
+    return STATUS_DATA_CONSISTENT;
+}
+
+/*
+ * VerdictReached:
+ * Verdict-only mode: true once a validator's contribution to the status
+ * is final. Folder problems are found before any file is looked at, so
+ * after that only MISSING/EXTRA can still be reached; once it is, the
+ * remaining files can't change the directory status.
+ */
+bool VerdictReached(int check, int flags) {
+    return gOptions.verdictOnly && CheckStatus(check, flags) >= STATUS_DATA_INCONSISTENT_MISSING_EXTRA;
+}
+
+/*
+ * FileRule:
+ * One kind of per-HW file, recognised by the name suffix after the last '_'
+ */
+struct FileRule {
+    const char* suffix;               // '_' + suffix without further '_' ("_elect.txt")
+    const char* noun;                 // Used in messages ("electron", "hole root")
+    const char* label;                // Status line label, padded
+    int ValidationResult::* counter;  // Counter for matching files
+    int check;                        // RULE_CHECK_* applied to each file
+    int countFlag;                    // Set when the count differs from hwCount
+};
+
+/*
+ * ModuleFileRule:
+ * A required module-level file, module_test_<dir><extension>
+ */
+struct ModuleFileRule {
+    const char* extension;  // Including the dot
+    int check;              // RULE_CHECK_* applied to the file
+    int flag;               // Set when the file is missing or fails the check
+};
+
+/*
+ * FolderRules:
+ * Declarative description of the files expected in one test subfolder.
+ * CompileFolderRules() builds the suffix index used by ClassifyFile().
+ */
+struct FolderRules {
+    const char* folder;               // Subfolder of the test directory
+    int hwCount;                      // Files required per rule (HW indices 0..hwCount-1, at most HW_INDEX_MAX)
+    bool parseHwIndex;                // Names carry a unique index between HW_INDEX_TAG and HW_INDEX_END
+    std::vector<FileRule> rules;      // Per-HW file kinds (at most FOLDER_MAX_RULES)
+    std::vector<ModuleFileRule> moduleFiles;   // Required module-level files
+    std::vector<std::string> auxFiles;         // Other accepted file names
+    int openFlag;                     // Set when a per-HW file fails its check
+    int unexpectedFlag;               // Set for files matching no rule
+
+    std::unordered_map<std::string_view, int> bySuffix;  // Suffix -> index into rules
+};
+
+FolderRules CompileFolderRules(FolderRules folder) {
+    if (folder.hwCount < 1 || folder.hwCount > HW_INDEX_MAX) {
+        std::cerr << "Error: HW count of " << folder.folder << " must be 1.." << HW_INDEX_MAX << std::endl;
+        folder.hwCount = std::min(std::max(folder.hwCount, 1), HW_INDEX_MAX);
+    }
+    if (folder.rules.size() > FOLDER_MAX_RULES) {
+        std::cerr << "Error: More than " << FOLDER_MAX_RULES << " file rules for " << folder.folder << std::endl;
+        folder.rules.resize(FOLDER_MAX_RULES);
+    }
+    for (size_t i = 0; i < folder.rules.size(); i++) {
+        std::string_view suffix = folder.rules[i].suffix;
+        if (suffix.empty() || suffix.rfind('_') != 0) {
+            std::cerr << "Error: Rule suffix must start with its only '_': " << suffix << std::endl;
+            continue;
+        }
+        folder.bySuffix[suffix] = (int)i;
+    }
+    return folder;
+}
+
+const FolderRules kTrimRules = CompileFolderRules({
+    "trim_files", MODULE_HW_COUNT, true,
+    {{"_elect.txt", "electron", "Electron files: ", &ValidationResult::electronCount, RULE_CHECK_TEXT, FLAG_ELECTRON_COUNT_TRIM},
+     {"_holes.txt", "hole",     "Hole files:     ", &ValidationResult::holeCount,     RULE_CHECK_TEXT, FLAG_HOLE_COUNT_TRIM}},
+    {}, {},
+    FLAG_FILE_OPEN_TRIM, FLAG_UNEXPECTED_FILES_TRIM,
+    {}  // Suffix index, built by CompileFolderRules
+});
+
+const FolderRules kPscanRules = CompileFolderRules({
+    "pscan_files", MODULE_HW_COUNT, false,
+    {{"_elect.txt",  "electron txt",  "Electron text files: ", &ValidationResult::electronTxtCount,  RULE_CHECK_TEXT, FLAG_ELECTRON_TXT},
+     {"_holes.txt",  "hole txt",      "Hole text files:     ", &ValidationResult::holeTxtCount,      RULE_CHECK_TEXT, FLAG_HOLE_TXT},
+     {"_elect.root", "electron root", "Electron ROOT files: ", &ValidationResult::electronRootCount, RULE_CHECK_ROOT, FLAG_ELECTRON_ROOT},
+     {"_holes.root", "hole root",     "Hole ROOT files:     ", &ValidationResult::holeRootCount,     RULE_CHECK_ROOT, FLAG_HOLE_ROOT}},
+    {{".root", RULE_CHECK_ROOT, FLAG_MODULE_ROOT},
+     {".txt", RULE_CHECK_TEXT, FLAG_MODULE_TXT},
+     {".pdf", RULE_CHECK_EXISTS, FLAG_MODULE_PDF}},
+    {"module_test_SETUP.root", "module_test_SETUP.txt", "module_test_SETUP.pdf"},
+    FLAG_FILE_OPEN_PSCAN, FLAG_UNEXPECTED_FILES_PSCAN,
+    {}  // Suffix index, built by CompileFolderRules
+});
+
+const FolderRules kConnRules = CompileFolderRules({
+    "conn_check_files", MODULE_HW_COUNT, false,
+    {{"_elect.txt", "electron", "Electron files: ", &ValidationResult::electronCount, RULE_CHECK_TEXT, FLAG_ELECTRON_COUNT},
+     {"_holes.txt", "hole",     "Hole files:     ", &ValidationResult::holeCount,     RULE_CHECK_TEXT, FLAG_HOLE_COUNT}},
+    {}, {},
+    FLAG_FILE_OPEN_CONN, FLAG_UNEXPECTED_FILES_CONN,
+    {}  // Suffix index, built by CompileFolderRules
+});
+
+/*
+ * ClassifyFile:
+ * Index of the rule matching fileName, RULE_AUX for an accepted auxiliary
+ * file, RULE_NONE otherwise. Per-HW files cost one backward scan and one
+ * hash lookup; module prefixes are only compared when no rule matches.
+ * modulePrefix is module_test_<dir> ("" accepts no module files).
+ */
+int ClassifyFile(const FolderRules& folder, std::string_view fileName, std::string_view modulePrefix = "") {
+    size_t underscore = fileName.rfind('_');
+    if (underscore != std::string_view::npos) {
+        auto rule = folder.bySuffix.find(fileName.substr(underscore));
+        if (rule != folder.bySuffix.end()) return rule->second;
+    }
+
+    if (folder.moduleFiles.empty()) return RULE_NONE;
+    if (!modulePrefix.empty() && fileName.substr(0, modulePrefix.size()) == modulePrefix) {
+        for (const auto& module : folder.moduleFiles) {
+            std::string_view extension = module.extension;
+            if (fileName.size() >= extension.size() &&
+                fileName.substr(fileName.size() - extension.size()) == extension) return RULE_AUX;
+        }
+    }
+    for (const auto& auxFile : folder.auxFiles) {
+        if (fileName == auxFile) return RULE_AUX;
+    }
+    return RULE_NONE;
+}
+
+#define HW_INDEX_OK              0
+#define HW_INDEX_BAD_FORMAT      1      // Tags missing or nothing between them
+#define HW_INDEX_NOT_NUMBER      2      // Non-digit characters in the index
+
+/*
+ * ParseHwIndex:
+ * Reads the index of a *_HW_<index>_SET_* name into hwIndex (HW_INDEX_* result).
+ * Indices too long for an int are returned as INT_MAX (out of any range).
+ */
+int ParseHwIndex(std::string_view fileName, int& hwIndex) {
+    size_t tagSize = sizeof(HW_INDEX_TAG) - 1;
+    size_t hwPos = fileName.find(HW_INDEX_TAG);
+    if (hwPos == std::string_view::npos) return HW_INDEX_BAD_FORMAT;
+    size_t setPos = fileName.find(HW_INDEX_END, hwPos + tagSize);
+    if (setPos == std::string_view::npos || setPos <= hwPos + tagSize) return HW_INDEX_BAD_FORMAT;
+
+    std::string_view digits = fileName.substr(hwPos + tagSize, setPos - (hwPos + tagSize));
+    long long value = 0;
+    for (char c : digits) {
+        if (!isdigit((unsigned char)c)) return HW_INDEX_NOT_NUMBER;
+        if (value <= INT_MAX) value = value * 10 + (c - '0');
+    }
+    hwIndex = (int)std::min<long long>(value, INT_MAX);
+    return HW_INDEX_OK;
+}
+
+/*
+ * CheckTextFile:
+ * False if the file cannot be opened; empty files are added to result.emptyFiles
+ */
+bool CheckTextFile(const TString& filePath, const FileEntry& entry, ValidationResult& result) {
+    FileProbe probe = ProbeFile(filePath, &entry);
+    if (!probe.readable) return false;
+    if (probe.size == 0) {
+        result.emptyFiles.push_back(entry.name);
+    }
+    return true;
+}
+
+/*
+ * ContentCheck Structure:
+ * Open/content check of one classified file. Run at once, or collected
+ * and run after the name and count checks in verdict-only mode.
+ */
+struct ContentCheck {
+    const FileEntry* entry;             // Snapshot entry of the file
+    TString filePath;                   // Full path
+    int check;                          // RULE_CHECK_* to apply
+    const char* whatPrefix;             // Message: "Cannot open " + whatPrefix + what + " file"
+    const char* what;
+    NameList ValidationResult::* list;  // Where a failing file is listed
+    int flag;                           // Set when the check fails
+};
+
+/*
+ * RunContentCheck:
+ * Applies a content check; false (with the failure recorded) if it fails
+ */
+bool RunContentCheck(const ContentCheck& content, ValidationResult& result) {
+    bool passed = true;
+    if (content.check == RULE_CHECK_ROOT) {
+        const TString& filePath = content.filePath;
+        passed = CachedCheck(RootCheckName(), filePath, *content.entry, [&]() { return RootFileIsValid(filePath); });
+    } else if (content.check == RULE_CHECK_TEXT) {
+        passed = CheckTextFile(content.filePath, *content.entry, result);
+    }
+    if (!passed) {
+        Err() << "Error: Cannot open " << content.whatPrefix << content.what << " file: "
+              << content.filePath << std::endl;
+        (result.*content.list).push_back(content.entry->name);
+        result.flags |= content.flag;
+    }
+    return passed;
+}
+
+/*
+ * SubmitContentCheck:
+ * Runs the check now, or queues it on deferred (verdict-only mode)
+ */
+void SubmitContentCheck(ContentCheck content, ValidationResult& result, std::vector<ContentCheck>* deferred) {
+    if (content.check == RULE_CHECK_EXISTS) return;
+    if (deferred) {
+        deferred->push_back(std::move(content));
+    } else {
+        RunContentCheck(content, result);
+    }
+}
+
+/*
+ * RunDeferredChecks:
+ * Runs queued content checks until the validator's verdict is reached
+ */
+void RunDeferredChecks(int check, const std::vector<ContentCheck>& deferred, ValidationResult& result) {
+    for (const auto& content : deferred) {
+        if (VerdictReached(check, result.flags)) return;
+        RunContentCheck(content, result);
+    }
+}
+
+/*
+ * CheckModuleFiles:
+ * Validates the required module_test_<dir> files of a folder
+ * (content checks go to deferred if given). The names are fixed, so a
+ * folder that can't be listed is checked by stat()ing them directly.
+ */
+void CheckModuleFiles(const FolderRules& folder, const DirectorySnapshot& snapshot, const TString& dirPath,
+                      const char* targetDir, ValidationResult& result, std::vector<ContentCheck>* deferred) {
+    for (const auto& module : folder.moduleFiles) {
+        std::string fileName = std::string(MODULE_FILE_PREFIX) + targetDir + module.extension;
+        const char* kind = module.extension + 1;
+        TString filePath = dirPath + "/" + fileName.c_str();
+
+        FileEntry statted;
+        const FileEntry* entry = nullptr;
+        if (snapshot.readable) {
+            entry = snapshot.Find(fileName);
+        } else {
+            statted.name = fileName;
+            StatEntry(filePath.Data(), statted);
+            if (statted.statOk) entry = &statted;
+        }
+        if (!entry) {
+            Err() << "Error: Module test " << kind << " file does not exist: " << filePath << std::endl;
+            result.moduleErrorFiles.push_back(fileName);
+            result.flags |= module.flag;
+            continue;
+        }
+        /* A stat()ed entry does not outlive this call, so it is never deferred */
+        SubmitContentCheck({entry, std::move(filePath), module.check, "module test ", kind,
+                            &ValidationResult::moduleErrorFiles, module.flag}, result,
+                           entry == &statted ? nullptr : deferred);
+    }
+}
+
+/*
+ * PrefetchRootFiles:
+ * Starts the read-ahead of every ROOT file of a folder (per-HW and module
+ * files) whose verdict is not cached, before any of them is checked. The
+ * storage round trips then overlap, and the checks run in listing order
+ * as before, mostly from the page cache.
+ */
+void PrefetchRootFiles(const FolderRules& folder, const DirectorySnapshot& snapshot, const TString& dirPath,
+                       const char* targetDir) {
+    std::vector<const FileEntry*> rootFiles;
+    for (const auto& module : folder.moduleFiles) {
+        if (module.check != RULE_CHECK_ROOT) continue;
+        const FileEntry* entry = snapshot.Find(std::string(MODULE_FILE_PREFIX) + targetDir + module.extension);
+        if (entry) rootFiles.push_back(entry);
+    }
+    std::string modulePrefix = std::string(MODULE_FILE_PREFIX) + targetDir;
+    for (const auto& entry : snapshot.entries) {
+        if (entry.isDirectory) continue;
+        int ruleIndex = ClassifyFile(folder, entry.name, modulePrefix);
+        if (ruleIndex >= 0 && folder.rules[ruleIndex].check == RULE_CHECK_ROOT) rootFiles.push_back(&entry);
+    }
+
+    for (const FileEntry* entry : rootFiles) {
+        TString filePath = dirPath + "/" + entry->name.c_str();
+        if (!HasCachedVerdict(RootCheckName(), filePath, *entry)) PrefetchRootFile(filePath);
+    }
+}
+
+/*
+ * ApplyFolderRules:
+ * Classifies and checks every file of a readable subfolder, then
+ * verifies the per-rule counts (content checks go to deferred if given)
+ */
+void ApplyFolderRules(const FolderRules& folder, const DirectorySnapshot& snapshot, const TString& dirPath,
+                      const char* targetDir, ValidationResult& result, std::vector<ContentCheck>* deferred) {
+    std::string modulePrefix = std::string(MODULE_FILE_PREFIX) + targetDir;
+    std::bitset<HW_INDEX_MAX> seenIndices[FOLDER_MAX_RULES];  // Per rule, when indices are parsed
+
+    for (const auto& entry : snapshot.entries) {
+        if (entry.isDirectory) continue;
+        const std::string& fileName = entry.name;
+        int ruleIndex = ClassifyFile(folder, fileName, modulePrefix);
+        if (ruleIndex == RULE_AUX) continue;
+
+        TString filePath = dirPath + "/" + fileName.c_str();
+        if (ruleIndex == RULE_NONE) {
+            Err() << "Warning: Unexpected file in " << folder.folder << ": " << filePath << std::endl;
+            result.unexpectedFiles.push_back(fileName);
+            result.flags |= folder.unexpectedFlag;
+            continue;
+        }
+        const FileRule& rule = folder.rules[ruleIndex];
+
+        if (folder.parseHwIndex) {
+            int hwIndex = 0;
+            int parsed = ParseHwIndex(fileName, hwIndex);
+            bool inRange = parsed == HW_INDEX_OK && hwIndex < folder.hwCount;
+            if (parsed == HW_INDEX_BAD_FORMAT) {
+                Err() << "Error: Invalid " << rule.noun << " file name format: " << fileName << std::endl;
+            } else if (parsed == HW_INDEX_NOT_NUMBER) {
+                Err() << "Error: Invalid HW index in " << rule.noun << " file: " << fileName << std::endl;
+            } else if (!inRange) {
+                Err() << "Error: HW index out of range (0-" << folder.hwCount - 1 << ") in "
+                      << rule.noun << " file: " << fileName << std::endl;
+            } else if (seenIndices[ruleIndex][hwIndex]) {
+                Err() << "Error: Duplicate HW index " << hwIndex << " in " << rule.noun << " files" << std::endl;
+                inRange = false;
+            }
+            if (!inRange) {
+                result.invalidFiles.push_back(fileName);
+                result.flags |= FLAG_DATA_INVALID;
+                continue;
+            }
+            seenIndices[ruleIndex][hwIndex] = true;
+        }
+
+        result.*rule.counter += 1;
+        SubmitContentCheck({&entry, std::move(filePath), rule.check, "", rule.noun,
+                            &ValidationResult::openErrorFiles, folder.openFlag}, result, deferred);
+    }
+
+    /* Every rule needs exactly hwCount files (with distinct indices when parsed) */
+    for (const auto& rule : folder.rules) {
+        int count = result.*rule.counter;
+        if (count != folder.hwCount) {
+            Err() << "Error: Incorrect number of " << rule.noun << " files: " << count << "/" << folder.hwCount << std::endl;
+            result.flags |= rule.countFlag;
+        }
+    }
+}
+
+/*
+ * PrintRuleCounts:
+ * Status lines with the per-rule file counts
+ */
+void PrintRuleCounts(const FolderRules& folder, const ValidationResult& result) {
+    for (const auto& rule : folder.rules) {
+        int count = result.*rule.counter;
+        Out() << rule.label << count << "/" << folder.hwCount << " | "
+              << ((result.flags & rule.countFlag) ? "FAIL" : "OK")
+              << (count < folder.hwCount ? " (UNDER)" : (count > folder.hwCount ? " (OVER)" : "")) << std::endl;
+    }
+}
+
+// ===================================================================
+// Validation Functions
+// ===================================================================
+
+/*
+ * FebMatcher:
+ * Pairs data files with tester FEB files in linear time.
+ * Tester timestamps (YYMMDD_HHMM) are indexed once; each tester file is
+ * handed out at most once, the oldest candidate first.
+ */
+class FebMatcher {
+public:
+    // testerPatterns must be sorted oldest first
+    explicit FebMatcher(const std::vector<std::string_view>& testerPatterns)
+        : matched(testerPatterns.size(), false) {
+        for (size_t i = 0; i < testerPatterns.size(); i++) {
+            byPattern[testerPatterns[i]].indices.push_back(i);
+        }
+    }
+
+    // Oldest unmatched tester with exactly this timestamp, -1 if none
+    int MatchPattern(std::string_view pattern) {
+        auto it = byPattern.find(pattern);
+        if (it == byPattern.end()) return -1;
+        Candidates& candidates = it->second;
+        while (candidates.next < candidates.indices.size()) {
+            size_t index = candidates.indices[candidates.next++];
+            if (!matched[index]) return Take(index);
+        }
+        return -1;
+    }
+
+    // Oldest unmatched tester of any timestamp, -1 if none
+    int MatchOldest() {
+        while (oldest < matched.size()) {
+            size_t index = oldest++;
+            if (!matched[index]) return Take(index);
+        }
+        return -1;
+    }
+
+private:
+    struct Candidates {
+        std::vector<size_t> indices;  // Tester indices, oldest first
+        size_t next = 0;              // First index not yet handed out
+    };
+
+    int Take(size_t index) {
+        matched[index] = true;
+        return (int)index;
+    }
+
+    std::unordered_map<std::string_view, Candidates> byPattern;  // Views into the tester names
+    std::vector<bool> matched;
+    size_t oldest = 0;
+};
+
+/*
+ * CheckLogFiles:
+ * Validates the log files and data files in a test directory
+ * 
+ * Parameters:
+ *   targetDir - Name of the directory to validate
+ *   currentDir - Ladder directory holding targetDir (defaults to the working directory)
+ * 
+ * Returns:
+ *   ValidationResult containing all findings
+ * 
+ * Checks:
+ * 1. Directory existence
+ * 2. Presence of main log file (<dir>_log.log)
+ * 3. Data files (*_data.dat) existence and content
+ * 4. Matching tester FEB files (tester_febs_*)
+ * 5. File naming conventions with timestamps
+ * 6. File accessibility and content validity
+ */
+ValidationResult CheckLogFiles(const char* targetDir, const TString& currentDir = gSystem->pwd()) {
+    ScopedStage stage(STAGE_LOG);
+    ValidationResult result;
+    TString fullTargetPath = TString::Format("%s/%s", currentDir.Data(), targetDir);
+
+    const DirectorySnapshot& snapshot = GetDirectorySnapshot(fullTargetPath);
+
+    // PRIMARY CHECK: Verify existence of target directory
+    if (!snapshot.exists) {
+        Err() << "\n===== CRITICAL ERROR =====" << std::endl;
+        Err() << "Target directory does not exist: " << fullTargetPath << std::endl;
+        result.flags |= FLAG_DIR_MISSING;
+        return result; // Can't proceed if directory is missing
+    }
+
+    /* Check for existence and accessibility of the primary log file */
+    TString logFileName = TString::Format("%s_log.log", targetDir);
+    TString logFilePath = fullTargetPath + "/" + logFileName;
+    if (const FileEntry* logEntry = snapshot.Find(logFileName.Data())) {
+        result.logExists = true;
+        if (!CheckFileAccess(logFilePath, logEntry, result.openErrorFiles)) {
+            Err() << "Error: Cannot open log file: " << logFilePath << std::endl;
+            result.flags |= FLAG_FILE_OPEN;
+        }
+    } else {
+        Err() << "Error: Log file does not exist: " << logFilePath << std::endl;
+        result.flags |= FLAG_LOG_MISSING;
+    }
+    if (VerdictReached(CHECK_LOG, result.flags)) return result;
+
+    // Directory traversal
+    if (!snapshot.readable) {
+        Err() << "Error: Could not read directory contents: " << fullTargetPath << std::endl;
+        result.flags |= FLAG_FILE_OPEN;
+        return result;
+    }
+
+    // Structure to store discovered files with their metadata
+    // (views into the directory snapshot, which outlives the check)
+    struct FileInfo {
+        std::string_view fileName;         // Just the filename
+        std::string_view dateTimePattern;  // Extracted timestamp (YYMMDD_HHMM)
+        bool isSpecialCase;                // Flag for files without timestamp
+    };
+
+    std::vector<FileInfo> dataFiles;    // Stores all found data files
+    std::vector<FileInfo> testerFiles;  // Stores all found tester FEB files
+    std::vector<const FileEntry*> deferredDataFiles;  // Verdict-only mode: checked after matching
+
+    // DATA FILE CONTENT VALIDATION
+    auto checkDataContent = [&](const FileEntry& entry) {
+        std::string_view fileName = entry.name;
+
+        // Size and readability come from the probe; the file is only
+        // opened (and read) when its content verdict is not cached
+        TString fullFilePath = fullTargetPath + "/" + entry.name.c_str();
+        FileProbe probe = ProbeFile(fullFilePath, &entry);
+        if (!probe.readable) {
+            Err() << "Error: Cannot open data file: " << fullFilePath << std::endl;
+            result.openErrorFiles.push_back(fileName);
+            result.flags |= FLAG_FILE_OPEN;
+        } else {
+            // Check file size first (quick check)
+            if (probe.size > 0) {
+                result.nonEmptyDataCount++;
+                // Perform detailed content validation
+                if (CachedCheck("data", fullFilePath, entry, [&]() { return CheckDataFileContent(fullFilePath.Data()); })) {
+                    result.validDataCount++;
+                } else {
+                    Err() << "Error: Invalid content in data file: " << fullFilePath << std::endl;
+                    result.invalidFiles.push_back(fileName);
+                    result.flags |= FLAG_DATA_INVALID;
+                }
+            } else {
+                Err() << "Warning: Empty data file: " << fullFilePath << std::endl;
+                result.emptyFiles.push_back(fileName);
+                result.flags |= FLAG_DATA_EMPTY;
+            }
+        }
+    };
+
+    // ===================================================================
+    // FILE PROCESSING LOOP
+    // ===================================================================
+    std::string_view targetName = targetDir;
+    for (const auto& entry : snapshot.entries) {
+        std::string_view fileName = entry.name;
+
+        // Skip directories
+        if (entry.isDirectory) continue;
+    
+        bool isExpectedFile = false;
+
+        // Skip the log file we already processed
+        if (fileName == logFileName.Data()) {
+            continue;
+        }
+
+        // Check for data files (two possible formats)
+        if (HasPrefix(fileName, targetName) && HasSuffix(fileName, "_data.dat")) {
+            isExpectedFile = true;
+            result.dataFileCount++;
+            
+            FileInfo info;
+            info.fileName = fileName;
+            info.isSpecialCase = false;
+
+            // Check for standard format: "folder_YYMMDD_HHMM_data.dat"
+            if (fileName.size() == (15 + 1 + 6 + 1 + 4 + 9)) { // 15 (folder) + _ + 6 (YYMMDD) + _ + 4 (HHMM) + _data.dat
+                info.dateTimePattern = fileName.substr(16, 11); // Extract YYMMDD_HHMM
+            } 
+            // Check for special case: "folder_data.dat"
+            else if (fileName.size() == targetName.size() + 9) {
+                info.isSpecialCase = true;
+            } else {
+                Err() << "Warning: Unexpected data file format: " << fileName << std::endl;
+                result.unexpectedFiles.push_back(fileName);
+                result.flags |= FLAG_UNEXPECTED_FILES;
+                continue; // Skip further processing for malformed names
+            }
+            
+            dataFiles.push_back(info);
+            if (gOptions.verdictOnly) {
+                deferredDataFiles.push_back(&entry);
+            } else {
+                checkDataContent(entry);
+            }
+        }
+        // TESTER FEB FILE PROCESSING
+        else if (HasPrefix(fileName, "tester_febs_") && fileName.find("_arr_") != std::string_view::npos) {
+            isExpectedFile = true;
+            
+            FileInfo info;
+            info.fileName = fileName;
+            info.isSpecialCase = false;
+            
+            // Extract timestamp from FEB filename (format: tester_febs_*_arr_YYMMDD_HHMM*)
+            size_t arrPos = fileName.find("_arr_");
+            if (fileName.size() >= arrPos + 5 + 11) {
+                info.dateTimePattern = fileName.substr(arrPos + 5, 11); // Extract YYMMDD_HHMM
+            } else {
+                Err() << "Warning: Invalid FEB file format: " << fileName << std::endl;
+                result.unexpectedFiles.push_back(fileName);
+                result.flags |= FLAG_UNEXPECTED_FILES;
+                continue;
+            }
+            
+            testerFiles.push_back(info);
+        }
+
+        // UNEXPECTED FILE HANDLING
+        if (!isExpectedFile) {
+            Err() << "Warning: Unexpected file found: " << fullTargetPath << "/" << fileName << std::endl;
+            result.unexpectedFiles.push_back(fileName);
+            result.flags |= FLAG_UNEXPECTED_FILES;
+        }
+    }
+
+    // ===================================================================
+    // DATA-TESTER FILE MATCHING
+    // ===================================================================
+    /* This complex matching handles two scenarios:
+     * 1. Normal case: Data file with timestamp matches tester file with same timestamp
+     * 2. Special case: Untimestamped data file matches with oldest available tester file
+     */
+    
+    {
+        ScopedStage matching(STAGE_MATCHING);
+
+        // Sort tester files chronologically (oldest first)
+        std::stable_sort(testerFiles.begin(), testerFiles.end(), [](const FileInfo& a, const FileInfo& b) {
+            return a.dateTimePattern < b.dateTimePattern;
+        });
+
+        std::vector<std::string_view> testerPatterns;
+        testerPatterns.reserve(testerFiles.size());
+        for (const auto& testerFile : testerFiles) {
+            testerPatterns.push_back(testerFile.dateTimePattern);
+        }
+        FebMatcher matcher(testerPatterns);
+
+        for (auto& dataFile : dataFiles) {
+            std::string_view matchedTester;  // Name of the tester paired with this data file
+
+            // Special case: data file without timestamp takes the oldest available tester file
+            int testerIndex = dataFile.isSpecialCase ? matcher.MatchOldest()
+                                                     : matcher.MatchPattern(dataFile.dateTimePattern);
+            bool foundMatch = (testerIndex >= 0);
+
+            if (foundMatch) {
+                const FileInfo& testerFile = testerFiles[testerIndex];
+                matchedTester = testerFile.fileName;
+                if (dataFile.isSpecialCase) {
+                    Trace() << "Info: Special case data file " << dataFile.fileName 
+                            << " matched with oldest available tester file " << testerFile.fileName 
+                            << " (pattern: " << testerFile.dateTimePattern << ")" << '\n';
+                } else {
+                    Trace() << "Info: Data file " << dataFile.fileName 
+                            << " matched with tester file " << testerFile.fileName 
+                            << " (pattern: " << dataFile.dateTimePattern << ")" << '\n';
+                }
+            }
+        
+            // No match found for this data file
+            if (!foundMatch) {
+                Err() << "Error: No matching tester file found for data file: " 
+                      << dataFile.fileName;
+                if (!dataFile.isSpecialCase) {
+                    Err() << " (pattern: " << dataFile.dateTimePattern << ")";
+                }
+                Err() << std::endl;
+                result.flags |= FLAG_NO_FEB_FILE;
+            }
+
+            result.foundFebFile &= foundMatch; // Update overall FEB file match status
+            result.dataTesterPairs.emplace_back(dataFile.fileName, matchedTester);
+        }
+    }
+
+    // Final check if we have data files but no FEB files at all
+    if (dataFiles.size() > 0 && testerFiles.size() == 0) {
+        Err() << "Error: No FEB files found in directory" << std::endl;
+        result.flags |= FLAG_NO_FEB_FILE;
+    }
+
+    /* Verdict-only mode: data contents only matter while the names all pass */
+    for (const FileEntry* entry : deferredDataFiles) {
+        if (VerdictReached(CHECK_LOG, result.flags)) return result;
+        checkDataContent(*entry);
+    }
+
+    // ===================================================================
+    // REPORT GENERATION
+    // ===================================================================
+    Out() << "\n===== Log Files Status =====" << std::endl;
+    Out() << "Log file:         " << (result.logExists ? "FOUND" : "MISSING") 
+          << (result.flags & FLAG_FILE_OPEN ? " (OPEN ERROR)" : "") << std::endl;
+    Out() << "Data files:       " << result.dataFileCount << " found | "
+          << (result.flags & FLAG_DATA_MISSING ? "NONE" : 
+                 (result.flags & FLAG_DATA_EMPTY) ? "SOME EMPTY" :
+                 (result.flags & FLAG_DATA_INVALID) ? "SOME INVALID" : "VALID") << std::endl;
+    Out() << "Non-empty files:  " << result.nonEmptyDataCount << "/" << result.dataFileCount << std::endl;
+    Out() << "Valid files:      " << result.validDataCount << "/" << result.dataFileCount << std::endl;
+    Out() << "Tester FEB files: " << testerFiles.size() << " found | "
+          << (result.flags & FLAG_NO_FEB_FILE ? "MISSING MATCHES" : "ALL MATCHED") << std::endl;
+
+    if (!result.emptyFiles.empty()) {
+        Out() << "\n===== Empty Data Files =====" << std::endl;
+        for (const auto& file : result.emptyFiles) {
+            Out() << " - " << file << std::endl;
+        }
+    }
+
+    if (!result.invalidFiles.empty()) {
+        Out() << "\n===== Invalid Data Files =====" << std::endl;
+        for (const auto& file : result.invalidFiles) {
+            Out() << " - " << file << std::endl;
+        }
+    }
+
+    if (!result.openErrorFiles.empty()) {
+        Out() << "\n===== File Open Errors =====" << std::endl;
+        for (const auto& file : result.openErrorFiles) {
+            Out() << " - " << file << std::endl;
+        }
+    }
+
+    if (!result.unexpectedFiles.empty()) {
+        Out() << "\n===== Unexpected Files =====" << std::endl;
+        for (const auto& file : result.unexpectedFiles) {
+            Out() << " - " << file << std::endl;
+        }
+    }
+
+    Out() << "\nSummary: ";
+    if (result.flags == 0) {
+        Out() << "ALL CHECKS PASSED";
+    } else {
+        if (result.flags & FLAG_DIR_MISSING) Out() << "[DIR MISSING] ";
+        if (result.flags & FLAG_LOG_MISSING) Out() << "[LOG MISSING] ";
+        if (result.flags & FLAG_DATA_MISSING) Out() << "[DATA MISSING] ";
+        if (result.flags & FLAG_NO_FEB_FILE) Out() << "[NO FEB FILES] ";
+        if (result.flags & FLAG_FILE_OPEN) Out() << "[FILE OPEN ERROR] ";
+        if (result.flags & FLAG_DATA_EMPTY) Out() << "[DATA EMPTY] ";
+        if (result.flags & FLAG_DATA_INVALID) Out() << "[DATA INVALID] ";
+        if (result.flags & FLAG_UNEXPECTED_FILES) Out() << "[UNEXPECTED FILES]";
+    }
+    Out() << std::endl;
+
+    return result;
+}
+
+/*
+ * CheckTrimFiles:
+ * Validates the trim adjustment files in the 'trim_files' subdirectory.
+ * Ensures proper count and naming convention of electron and hole trim files.
+ * 
+ * Parameters:
+ *   targetDir - Parent directory containing trim_files
+ *   currentDir - Ladder directory holding targetDir (defaults to the working directory)
+ * 
+ * Returns:
+ *   ValidationResult with trim file findings
+ * 
+ * Checks:
+ * 1. trim_files subdirectory existence
+ * 2. Exactly MODULE_HW_COUNT electron files (*_elect.txt)
+ * 3. Exactly MODULE_HW_COUNT hole files (*_holes.txt)
+ * 4. Proper HW index format (0 to MODULE_HW_COUNT-1) in filenames
+ * 5. No duplicate HW indices
+ * 6. File accessibility
+ * 7. No unexpected files in directory
+ */
+ValidationResult CheckTrimFiles(const char* targetDir, const TString& currentDir = gSystem->pwd()) {
+    ScopedStage stage(STAGE_TRIM);
+    ValidationResult result;
+    TString fullTargetPath = TString::Format("%s/%s", currentDir.Data(), targetDir);
+    TString trimDirPath = TString::Format("%s/%s/trim_files", currentDir.Data(), targetDir);
+
+    const DirectorySnapshot& snapshot = GetDirectorySnapshot(trimDirPath);
+
+    // PRIMARY CHECK: Verify existence of 'trim_files' directory
+    if (!snapshot.exists) {
+        Err() << "\n===== CRITICAL ERROR =====" << std::endl;
+        Err() << "Directory 'trim_files' does not exist in target folder!" << std::endl;
+        Err() << "Target folder: " << fullTargetPath << std::endl;
+        Err() << "Expected path: " << trimDirPath << std::endl;
+        result.flags |= FLAG_TRIM_FOLDER_MISSING;
+        return result;
+    }
+
+    // DIRECTORY SCANNING INITIALIZATION
+    if (!snapshot.readable) {
+        Err() << "Error: Could not read directory contents: " << trimDirPath << std::endl;
+        result.flags |= FLAG_DIR_ACCESS_TRIM;
+        return result;
+    }
+
+    // ===================================================================
+    // FILE PROCESSING AND COUNT VALIDATION
+    // ===================================================================
+    /* Rules require MODULE_HW_COUNT electron and hole files with unique HW indices.
+     * Verdict-only mode opens files only if the names and counts pass. */
+    std::vector<ContentCheck> deferred;
+    ApplyFolderRules(kTrimRules, snapshot, trimDirPath, targetDir, result,
+                     gOptions.verdictOnly ? &deferred : nullptr);
+    RunDeferredChecks(CHECK_TRIM, deferred, result);
+
+    // Generate detailed report
+    Out() << "\n===== Trim Files Status =====" << std::endl;
+    PrintRuleCounts(kTrimRules, result);
+    Out() << "File name format: " << (result.invalidFiles.empty() ? "ALL VALID" : "ERRORS DETECTED") << std::endl;
+    Out() << "File accessibility: " << (result.openErrorFiles.empty() ? "ALL OK" : "ERRORS") << std::endl;
+
+    if (!result.emptyFiles.empty()) {
+        Out() << "\n===== Empty Files =====" << std::endl;
+        for (const auto& file : result.emptyFiles) {
+            Out() << " - " << file << std::endl;
+        }
+    }
+
+    if (!result.invalidFiles.empty()) {
+        Out() << "\n===== Invalid Files (Bad Name Format) =====" << std::endl;
+        for (const auto& file : result.invalidFiles) {
+            Out() << " - " << file << std::endl;
+        }
+    }
+
+    if (!result.openErrorFiles.empty()) {
+        Out() << "\n===== File Open Errors =====" << std::endl;
+        for (const auto& file : result.openErrorFiles) {
+            Out() << " - " << file << std::endl;
+        }
+    }
+
+    if (!result.unexpectedFiles.empty()) {
+        Out() << "\n===== Unexpected Files =====" << std::endl;
+        for (const auto& file : result.unexpectedFiles) {
+            Out() << " - " << file << std::endl;
+        }
+    }
+
+    Out() << "\nSummary: ";
+    if (result.flags == 0) {
+        Out() << "ALL CHECKS PASSED";
+    } else {
+        if (result.flags & FLAG_TRIM_FOLDER_MISSING) Out() << "[FOLDER MISSING] ";
+        if (result.flags & FLAG_DIR_ACCESS_TRIM) Out() << "[DIR ACCESS ERROR] ";
+        if (result.flags & FLAG_ELECTRON_COUNT_TRIM) Out() << "[ELECTRON COUNT] ";
+        if (result.flags & FLAG_HOLE_COUNT_TRIM) Out() << "[HOLE COUNT] ";
+        if (result.flags & FLAG_FILE_OPEN_TRIM) Out() << "[FILE OPEN ERROR] ";
+        if (result.flags & FLAG_DATA_INVALID) Out() << "[INVALID FILENAME] ";
+        if (result.flags & FLAG_UNEXPECTED_FILES_TRIM) Out() << "[UNEXPECTED FILES]";
+    }
+    Out() << std::endl;
+
+    return result;
+}
+
+/*
+ * CheckPscanFiles:
+ * Validates the parameter scan (pscan) files in the 'pscan_files' subdirectory.
+ * This includes checking for required module files and per-HW electron/hole files.
+ * 
+ * Parameters:
+ *   targetDir - Parent directory containing pscan_files
+ *   currentDir - Ladder directory holding targetDir (defaults to the working directory)
+ * 
+ * Returns:
+ *   ValidationResult with pscan file findings
+ * 
+ * Checks:
+ * 1. pscan_files subdirectory existence
+ * 2. Module test files (root/txt/pdf)
+ * 3. Exactly MODULE_HW_COUNT electron text files (*_elect.txt)
+ * 4. Exactly MODULE_HW_COUNT hole text files (*_holes.txt)
+ * 5. Exactly MODULE_HW_COUNT electron root files (*_elect.root)
+ * 6. Exactly MODULE_HW_COUNT hole root files (*_holes.root)
+ * 7. File accessibility and validity
+ * 8. No unexpected files in directory
+ */
+ValidationResult CheckPscanFiles(const char* targetDir, const TString& currentDir = gSystem->pwd()) {
+    ScopedStage stage(STAGE_PSCAN);
+    ValidationResult result;
+    TString pscanDirPath = TString::Format("%s/%s/pscan_files", currentDir.Data(), targetDir);
+
+    const DirectorySnapshot& snapshot = GetDirectorySnapshot(pscanDirPath);
+
+    // PRIMARY CHECK: Verify existence of the required 'pscan_files' subdirectory */
+    if (!snapshot.exists) {
+        Err() << "\n===== CRITICAL ERROR =====" << std::endl;
+        Err() << "Directory 'pscan_files' does not exist!" << std::endl;
+        Err() << "Expected path: " << pscanDirPath << std::endl;
+        result.flags |= FLAG_PSCAN_FOLDER_MISSING;
+        return result; // Cannot proceed without this directory
+    }
+
+    // ===================================================================
+    // MODULE TEST FILES VALIDATION
+    // ===================================================================
+    /* Check required module-level files:
+     * 1. module_test_<dir>.root - ROOT format results
+     * 2. module_test_<dir>.txt  - Text summary
+     * 3. module_test_<dir>.pdf  - Report PDF (existence only)
+     */
+    std::vector<ContentCheck> deferred;  // Verdict-only mode: opened after the name and count checks
+    std::vector<ContentCheck>* defer = gOptions.verdictOnly ? &deferred : nullptr;
+    if (!defer) PrefetchRootFiles(kPscanRules, snapshot, pscanDirPath, targetDir);
+    CheckModuleFiles(kPscanRules, snapshot, pscanDirPath, targetDir, result, defer);
+
+    // ===================================================================
+    // PER-HW FILES VALIDATION
+    // ===================================================================
+    if (!snapshot.readable) {
+        Err() << "Error: Could not read directory contents: " << pscanDirPath << std::endl;
+        result.flags |= FLAG_DIR_ACCESS_PSCAN;
+        return result;
+    }
+
+    /* Per-HW files, module_test_<dir>* and module_test_SETUP.* are accepted */
+    ApplyFolderRules(kPscanRules, snapshot, pscanDirPath, targetDir, result, defer);
+    if (defer && !VerdictReached(CHECK_PSCAN, result.flags)) {
+        for (const auto& content : deferred) {
+            if (content.check == RULE_CHECK_ROOT && !HasCachedVerdict(RootCheckName(), content.filePath, *content.entry)) {
+                PrefetchRootFile(content.filePath);
+            }
+        }
+    }
+    RunDeferredChecks(CHECK_PSCAN, deferred, result);
+
+    // Generate detailed report
+    Out() << "\n===== Pscan Files Status =====" << std::endl;
+    PrintRuleCounts(kPscanRules, result);
+    Out() << "Module test root:  " << (result.flags & FLAG_MODULE_ROOT ? "ERROR" : "OK") << std::endl;
+    Out() << "Module test txt:   " << (result.flags & FLAG_MODULE_TXT ? "ERROR" : "OK") << std::endl;
+    Out() << "Module test pdf:   " << (result.flags & FLAG_MODULE_PDF ? "MISSING" : "OK") << std::endl;
+    Out() << "File accessibility:    " << (result.openErrorFiles.empty() ? "ALL OK" : "ERRORS DETECTED") << std::endl;
+
+    if (!result.emptyFiles.empty()) {
+        Out() << "\n===== Empty Files =====" << std::endl;
+        for (const auto& file : result.emptyFiles) {
+            Out() << " - " << file << std::endl;
+        }
+    }
+
+    if (!result.moduleErrorFiles.empty()) {
+        Out() << "\n===== Module Test Errors =====" << std::endl;
+        for (const auto& file : result.moduleErrorFiles) {
+            Out() << " - " << file << std::endl;
+        }
+    }
+
+    if (!result.openErrorFiles.empty()) {
+        Out() << "\n===== File Open Errors =====" << std::endl;
+        for (const auto& file : result.openErrorFiles) {
+            Out() << " - " << file << std::endl;
+        }
+    }
+
+    if (!result.unexpectedFiles.empty()) {
+        Out() << "\n===== Unexpected Files =====" << std::endl;
+        for (const auto& file : result.unexpectedFiles) {
+            Out() << " - " << file << std::endl;
+        }
+    }
+
+    Out() << "\nSummary: ";
+    if (result.flags == 0) {
+        Out() << "ALL CHECKS PASSED";
+    } else {
+        if (result.flags & FLAG_PSCAN_FOLDER_MISSING) Out() << "[FOLDER MISSING] ";
+        if (result.flags & FLAG_DIR_ACCESS_PSCAN) Out() << "[DIR ACCESS ERROR] ";
+        if (result.flags & FLAG_ELECTRON_TXT) Out() << "[ELECTRON TXT COUNT] ";
+        if (result.flags & FLAG_HOLE_TXT) Out() << "[HOLE TXT COUNT] ";
+        if (result.flags & FLAG_ELECTRON_ROOT) Out() << "[ELECTRON ROOT COUNT] ";
+        if (result.flags & FLAG_HOLE_ROOT) Out() << "[HOLE ROOT COUNT] ";
+        if (result.flags & FLAG_FILE_OPEN_PSCAN) Out() << "[FILE OPEN ERROR] ";
+        if (result.flags & FLAG_MODULE_ROOT) Out() << "[MODULE ROOT ERROR] ";
+        if (result.flags & FLAG_MODULE_TXT) Out() << "[MODULE TXT ERROR] ";
+        if (result.flags & FLAG_MODULE_PDF) Out() << "[MODULE PDF MISSING] ";
+        if (result.flags & FLAG_UNEXPECTED_FILES_PSCAN) Out() << "[UNEXPECTED FILES]";
+    }
+    Out() << std::endl;
+
+    return result;
+}
+
+/*
+ * CheckConnFiles:
+ * Validates connection test files in the 'conn_check_files' subdirectory.
+ * Ensures proper count and accessibility of electron and hole connection files.
+ * 
+ * Parameters:
+ *   targetDir - Parent directory containing conn_check_files
+ *   currentDir - Ladder directory holding targetDir (defaults to the working directory)
+ * 
+ * Returns:
+ *   ValidationResult with connection file findings
+ * 
+ * Checks:
+ * 1. conn_check_files subdirectory existence
+ * 2. Exactly MODULE_HW_COUNT electron files (*_elect.txt)
+ * 3. Exactly MODULE_HW_COUNT hole files (*_holes.txt)
+ * 4. File accessibility
+ * 5. No unexpected files in directory
+ */
+ValidationResult CheckConnFiles(const char* targetDir, const TString& currentDir = gSystem->pwd()) {
+    ScopedStage stage(STAGE_CONN);
+    ValidationResult result;
+    TString fullTargetPath = TString::Format("%s/%s", currentDir.Data(), targetDir);
+    TString connDirPath = TString::Format("%s/%s/conn_check_files", currentDir.Data(), targetDir);
+
+    const DirectorySnapshot& snapshot = GetDirectorySnapshot(connDirPath);
+
+    // PRIMARY CHECK: Verify existence of the required 'conn_check_files' subdirectory */
+    if (!snapshot.exists) {
+        Err() << "\n===== CRITICAL ERROR =====" << std::endl;
+        Err() << "Directory 'conn_check_files' does not exist!" << std::endl;
+        Err() << "Target folder: " << fullTargetPath << std::endl;
+        Err() << "Expected path: " << connDirPath << std::endl;
+        result.flags |= FLAG_CONN_FOLDER_MISSING;
+        return result; // Cannot proceed without this directory
+    }
+
+    // ===================================================================
+    // DIRECTORY SCANNING INITIALIZATION
+    // ===================================================================
+    if (!snapshot.readable) {
+        Err() << "Error: Could not read directory contents: " << connDirPath << std::endl;
+        result.flags |= FLAG_DIR_ACCESS;
+        return result;
+    }
+
+    // ===================================================================
+    // FILE PROCESSING AND COUNT VALIDATION
+    // ===================================================================
+    /* Rules require exactly MODULE_HW_COUNT files for each type. Verdict-only mode
+     * opens files only if the names and counts pass. */
+    std::vector<ContentCheck> deferred;
+    ApplyFolderRules(kConnRules, snapshot, connDirPath, targetDir, result,
+                     gOptions.verdictOnly ? &deferred : nullptr);
+    RunDeferredChecks(CHECK_CONN, deferred, result);
+
+    // Generate detailed report
+    Out() << "\n===== Connection Files Status =====" << std::endl;
+    PrintRuleCounts(kConnRules, result);
+    Out() << "File accessibility: " << (result.openErrorFiles.empty() ? "ALL OK" : "ERRORS DETECTED") << std::endl;
+
+    if (!result.emptyFiles.empty()) {
+        Out() << "\n===== Empty Files =====" << std::endl;
+        for (const auto& file : result.emptyFiles) {
+            Out() << " - " << file << std::endl;
+        }
+    }
+
+    if (!result.openErrorFiles.empty()) {
+        Out() << "\n===== File Open Errors =====" << std::endl;
+        for (const auto& file : result.openErrorFiles) {
+            Out() << " - " << file << std::endl;
+        }
+    }
+
+    if (!result.unexpectedFiles.empty()) {
+        Out() << "\n===== Unexpected Files =====" << std::endl;
+        for (const auto& file : result.unexpectedFiles) {
+            Out() << " - " << file << std::endl;
+        }
+    }
+
+    Out() << "\nSummary: ";
+    if (result.flags == 0) {
+        Out() << "ALL CHECKS PASSED";
+    } else {
+        if (result.flags & FLAG_CONN_FOLDER_MISSING) Out() << "[FOLDER MISSING] ";
+        if (result.flags & FLAG_DIR_ACCESS) Out() << "[DIR ACCESS ERROR] ";
+        if (result.flags & FLAG_ELECTRON_COUNT) Out() << "[ELECTRON COUNT] ";
+        if (result.flags & FLAG_HOLE_COUNT) Out() << "[HOLE COUNT] ";
+        if (result.flags & FLAG_FILE_OPEN_CONN) Out() << "[FILE OPEN ERROR] ";
+        if (result.flags & FLAG_UNEXPECTED_FILES_CONN) Out() << "[UNEXPECTED FILES]";
+    }
+    Out() << std::endl;
+
+    return result;
+}
+
+/*
+ * ValidateDirectory:
+ * Runs all four validation functions for one test directory
+ *
+ * Parameters:
+ *   dirName    - Name of the directory to validate
+ *   currentDir - Ladder directory holding dirName
+ */
+DirectoryValidation ValidateDirectory(const TString& dirName, const TString& currentDir) {
+    DirectoryValidation validation;
+    validation.dirName = dirName;
+    validation.logResult = CheckLogFiles(dirName.Data(), currentDir);
+    validation.trimResult = CheckTrimFiles(dirName.Data(), currentDir);
+    validation.pscanResult = CheckPscanFiles(dirName.Data(), currentDir);
+    validation.connResult = CheckConnFiles(dirName.Data(), currentDir);
+    return validation;
+}
+
+// ===================================================================
+// Checkpoint Journal
+// ===================================================================
+
+#define JOURNAL_FILE            ".exorcism_journal"  // Inside the ladder folder
+#define JOURNAL_HEADER          "# EXORCISM journal v2"
+#define JOURNAL_SYNC_RECORDS    32   // Records between fdatasync() calls
+
+/*
+ * DirectoryFingerprint:
+ * Hash of the snapshots the validators of a directory read: the test
+ * directory and its three subfolders, with the name, size, modification
+ * time and inode of every entry. Paths are built like the validators
+ * build them, so the (cached) snapshots are shared.
+ */
+ULong64_t DirectoryFingerprint(const TString& ladderDir, const TString& dirName) {
+    TString dirPath = TString::Format("%s/%s", ladderDir.Data(), dirName.Data());
+    std::ostringstream key;
+    for (const char* subdir : {"", kTrimRules.folder, kPscanRules.folder, kConnRules.folder}) {
+        const DirectorySnapshot& snapshot = GetDirectorySnapshot(*subdir ? dirPath + "/" + subdir : dirPath);
+        key << subdir << '|' << snapshot.exists << snapshot.readable << '\n';
+        for (const auto& entry : snapshot.entries) {
+            key << entry.name << '\t' << entry.size << '\t' << entry.mtime << '\t' << entry.inode << '\t'
+                << entry.isDirectory << entry.statOk << '\n';
+        }
+    }
+    return StableHash(key.str());
+}
+
+/*
+ * JournalEscape / JournalUnescape:
+ * Tab-separated journal fields; tabs, newlines and backslashes in names
+ * are backslash-escaped
+ */
+void JournalEscape(std::string_view text, std::string& out) {
+    for (char c : text) {
+        switch (c) {
+            case '\\': out += "\\\\"; break;
+            case '\t': out += "\\t"; break;
+            case '\n': out += "\\n"; break;
+            default:   out += c;
+        }
+    }
+}
+
+std::string JournalUnescape(std::string_view text) {
+    std::string out;
+    out.reserve(text.size());
+    for (size_t i = 0; i < text.size(); i++) {
+        if (text[i] != '\\' || i + 1 == text.size()) {
+            out += text[i];
+            continue;
+        }
+        char c = text[++i];
+        out += (c == 't') ? '\t' : (c == 'n') ? '\n' : c;
+    }
+    return out;
+}
+
+/*
+ * Journal Record Fields:
+ * Scalar members of ValidationResult, in record order
+ */
+int ValidationResult::* const kJournalCounters[] = {
+    &ValidationResult::flags, &ValidationResult::dataFileCount, &ValidationResult::nonEmptyDataCount,
+    &ValidationResult::validDataCount, &ValidationResult::electronCount, &ValidationResult::holeCount,
+    &ValidationResult::electronTxtCount, &ValidationResult::holeTxtCount,
+    &ValidationResult::electronRootCount, &ValidationResult::holeRootCount
+};
+NameList ValidationResult::* const kJournalLists[] = {
+    &ValidationResult::openErrorFiles, &ValidationResult::unexpectedFiles, &ValidationResult::emptyFiles,
+    &ValidationResult::invalidFiles, &ValidationResult::moduleErrorFiles
+};
+
+/*
+ * EncodeJournalRecord:
+ * One journal line: directory, fingerprint, the four results, "end"
+ */
+std::string EncodeJournalRecord(const DirectoryValidation& validation, ULong64_t fingerprint) {
+    std::string line;
+    JournalEscape(validation.dirName.Data(), line);
+    line += TString::Format("\t%016llx", (unsigned long long)fingerprint).Data();
+    for (const ValidationResult* result : {&validation.logResult, &validation.trimResult,
+                                           &validation.pscanResult, &validation.connResult}) {
+        for (auto counter : kJournalCounters) line += "\t" + std::to_string(result->*counter);
+        line += result->foundFebFile ? "\t1" : "\t0";
+        line += result->logExists ? "\t1" : "\t0";
+        for (auto list : kJournalLists) {
+            line += "\t" + std::to_string((result->*list).size());
+            for (const auto& name : result->*list) {
+                line += "\t";
+                JournalEscape(name, line);
+            }
+        }
+        line += "\t" + std::to_string(result->dataTesterPairs.size());
+        for (const auto& pair : result->dataTesterPairs) {
+            line += "\t";
+            JournalEscape(pair.first, line);
+            line += "\t";
+            JournalEscape(pair.second, line);
+        }
+    }
+    line += "\tend\n";
+    return line;
+}
+
+/*
+ * DecodeJournalRecord:
+ * Parses a line written by EncodeJournalRecord
+ *
+ * Returns:
+ *   false for a damaged record (e.g. cut off when the run was killed)
+ */
+bool DecodeJournalRecord(const std::string& line, DirectoryValidation& validation, ULong64_t& fingerprint) {
+    std::vector<std::string_view> fields;
+    size_t begin = 0;
+    while (true) {
+        size_t tab = line.find('\t', begin);
+        fields.push_back(std::string_view(line).substr(begin, tab == std::string::npos ? std::string::npos : tab - begin));
+        if (tab == std::string::npos) break;
+        begin = tab + 1;
+    }
+    if (fields.size() < 3 || fields.back() != "end") return false;
+
+    size_t pos = 0;
+    bool ok = true;
+    auto number = [&]() -> long long {
+        if (pos + 1 >= fields.size()) { ok = false; return 0; }
+        std::string field(fields[pos++]);
+        char* end = nullptr;
+        long long value = strtoll(field.c_str(), &end, 10);
+        if (field.empty() || *end) ok = false;
+        return value;
+    };
+    auto text = [&]() -> std::string {
+        if (pos + 1 >= fields.size()) { ok = false; return ""; }
+        return JournalUnescape(fields[pos++]);
+    };
+
+    validation.dirName = text().c_str();
+    fingerprint = strtoull(std::string(fields[pos++]).c_str(), nullptr, 16);
+    for (ValidationResult* result : {&validation.logResult, &validation.trimResult,
+                                     &validation.pscanResult, &validation.connResult}) {
+        for (auto counter : kJournalCounters) result->*counter = (int)number();
+        result->foundFebFile = number() != 0;
+        result->logExists = number() != 0;
+        for (auto list : kJournalLists) {
+            for (long long n = number(); ok && n > 0; n--) (result->*list).push_back(text());
+        }
+        for (long long n = number(); ok && n > 0; n--) {
+            std::string dataFile = text();
+            result->dataTesterPairs.emplace_back(std::move(dataFile), text());
+        }
+        if (!ok) return false;
+    }
+    return pos + 1 == fields.size();
+}
+
+/*
+ * ValidationJournal:
+ * Append-only checkpoint of a validation pass in <ladder>/.exorcism_journal.
+ * Every recorded directory is appended as one line with the fingerprint of
+ * its snapshots, so an interrupted run only loses the directories that
+ * were still being validated. With --resume the next run takes journaled
+ * directories whose fingerprint is unchanged instead of validating them
+ * again. The journal is deleted once its pass has been saved to reports.
+ */
+class ValidationJournal {
+public:
+    ValidationJournal(const TString& ladderDir, bool resume)
+        : ladder(ladderDir), path(std::string(ladderDir.Data()) + "/" + JOURNAL_FILE) {
+        std::string header = std::string(JOURNAL_HEADER) + "\t" + RootCheckName() + "\t" +
+                             std::to_string(MODULE_HW_COUNT) + "\t" +
+                             (gOptions.verdictOnly ? "verdict" : "full");
+        bool append = resume && Load(header);
+        fd = open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC | (append ? 0 : O_TRUNC), 0644);
+        CountIo(1);
+        if (fd < 0) {
+            std::cerr << "Warning: Could not open checkpoint journal: " << path << std::endl;
+        } else if (!append) {
+            Write(header + "\n");
+        }
+    }
+
+    ~ValidationJournal() {
+        if (fd < 0) return;
+        fdatasync(fd);
+        close(fd);
+        CountIo(2);
+    }
+
+    ValidationJournal(const ValidationJournal&) = delete;
+    ValidationJournal& operator=(const ValidationJournal&) = delete;
+
+    /*
+     * Takes the journaled result of every directory whose snapshots are
+     * unchanged: validations[i] is filled and checkMasks[i] cleared. The
+     * cached verdicts of those directories count as used.
+     * Returns the number of directories resumed.
+     */
+    int Resume(std::vector<DirectoryValidation>& validations, std::vector<int>& checkMasks) {
+        std::set<std::string> resumedDirs;
+        for (size_t i = 0; i < validations.size(); i++) {
+            auto it = records.find(validations[i].dirName.Data());
+            if (it == records.end() || !checkMasks[i]) continue;
+            if (it->second.first != DirectoryFingerprint(ladder, validations[i].dirName)) continue;
+            DirectoryValidation journaled;
+            ULong64_t fingerprint = 0;
+            if (!DecodeJournalRecord(it->second.second, journaled, fingerprint)) continue;
+            validations[i] = std::move(journaled);
+            checkMasks[i] = 0;
+            resumedDirs.insert(validations[i].dirName.Data());
+        }
+        MarkCachedVerdictsUsed(ladder, resumedDirs);
+        if (!records.empty()) {
+            std::cout << "Resuming: " << resumedDirs.size() << " of " << validations.size()
+                      << " directories unchanged since the interrupted run" << std::endl;
+        }
+        return (int)resumedDirs.size();
+    }
+
+    // Checkpoints a recorded directory (called with gStateMutex held)
+    void Append(const DirectoryValidation& validation) {
+        if (fd < 0) return;
+        ULong64_t fingerprint = DirectoryFingerprint(ladder, validation.dirName);
+        auto it = records.find(validation.dirName.Data());
+        if (it != records.end() && it->second.first == fingerprint) return;  // Resumed, already in the file
+        Write(EncodeJournalRecord(validation, fingerprint));
+        if (++unsynced >= JOURNAL_SYNC_RECORDS) {
+            fdatasync(fd);  // Also survive a node crash, not only a killed process
+            CountIo(1);
+            unsynced = 0;
+        }
+    }
+
+    // The pass was saved to reports: nothing left to resume
+    void Remove() {
+        if (fd >= 0) close(fd);
+        fd = -1;
+        unlink(path.c_str());
+        CountIo(2);
+    }
+
+private:
+    // Reads the records of an earlier run; false if there is no usable journal
+    bool Load(const std::string& header) {
+        std::ifstream in(path.c_str());
+        std::string line;
+        if (!in.is_open() || !std::getline(in, line)) return false;
+        if (line != header) {
+            std::cerr << "Warning: Checkpoint journal was written with other settings, not resuming: "
+                      << path << std::endl;
+            return false;
+        }
+        while (std::getline(in, line)) {
+            if (in.eof()) break;  // Last line without newline: cut off
+            size_t tab = line.find('\t');
+            size_t tab2 = (tab == std::string::npos) ? tab : line.find('\t', tab + 1);
+            if (tab2 == std::string::npos) continue;
+            std::string dirName = JournalUnescape(std::string_view(line).substr(0, tab));
+            ULong64_t fingerprint = strtoull(line.substr(tab + 1, tab2 - tab - 1).c_str(), nullptr, 16);
+            records[dirName] = {fingerprint, line};  // Later records win
+        }
+        return true;
+    }
+
+    void Write(const std::string& text) {
+        ssize_t written = write(fd, text.data(), text.size());
+        CountIo(1, std::max<ssize_t>(written, 0));
+        if (written != (ssize_t)text.size()) {
+            std::cerr << "Warning: Could not write checkpoint journal, checkpointing stops: " << path << std::endl;
+            close(fd);
+            fd = -1;
+        }
+    }
+
+    TString ladder;                // Ladder folder (validator paths are relative to it)
+    std::string path;              // Journal file
+    int fd = -1;                   // Append descriptor (-1 = not journaling)
+    int unsynced = 0;              // Records since the last fdatasync
+    std::map<std::string, std::pair<ULong64_t, std::string>> records;  // Earlier run: dir -> fingerprint, line
+};
+
+/*
+ * OpenJournal:
+ * Checkpoint journal for the first validation pass over a ladder,
+ * nullptr with --no-journal or --verdict-only, whose short-circuited
+ * results must never be resumed as complete ones
+ */
+std::shared_ptr<ValidationJournal> OpenJournal(const TString& ladderDir) {
+    if (!gOptions.journal || gOptions.verdictOnly) return nullptr;
+    return std::make_shared<ValidationJournal>(ladderDir, gOptions.resume);
+}
+
+// ===================================================================
+// Reporting Functions
+// ===================================================================
+
+/*
+ * EvaluateDirectoryStatus:
+ * Determines the overall status of a validated directory
+ *
+ * Parameters:
+ *   validation - Results of all four validators
+ *   statusStr  - Receives the human-readable status label
+ *
+ * Returns:
+ *   One of the STATUS_* levels
+ */
+int EvaluateDirectoryStatus(const DirectoryValidation& validation, std::string& statusStr) {
+    const ValidationResult* results[4] = {&validation.logResult, &validation.trimResult,
+                                          &validation.pscanResult, &validation.connResult};
+
+    /* Status hierarchy: DIRECTORY PROBLEM> INCONSISTENT DATA (MISSING/EXTRA) > INCONSISTENT DATA (AUXILIARY FILES) > CONSISTENT DATA */
+    int dirStatus = STATUS_DATA_CONSISTENT;
+    for (int c = 0; c < 4; c++) {
+        dirStatus = std::max(dirStatus, CheckStatus(kStatusMasks[c].check, results[c]->flags));
+    }
+    statusStr = kStatusNames[dirStatus];
+    if (dirStatus == STATUS_DATA_CONSISTENT) statusStr += " ";  // Report label of earlier versions
+
+    return dirStatus;
+}
+
+/*
+ * BuildReportPage:
+ * Formats the detailed text report of a single validated directory
+ *
+ * Parameters:
+ *   validation - Results of all four validators
+ *   statusStr  - Status label from EvaluateDirectoryStatus
+ */
+std::string BuildReportPage(const DirectoryValidation& validation, const std::string& statusStr) {
+    const ValidationResult& logResult = validation.logResult;
+    const ValidationResult& trimResult = validation.trimResult;
+    const ValidationResult& pscanResult = validation.pscanResult;
+    const ValidationResult& connResult = validation.connResult;
+    std::stringstream report; // String stream to build the report
+    
+    // ===================================================================
+    // REPORT HEADER
+    // ===================================================================
+    report << "====================================================" << std::endl;
+    report << "VALIDATION REPORT FOR: " << validation.dirName << std::endl;
+    report << "====================================================" << std::endl;
+    
+    // 1. STATUS HEADER
+    report << "STATUS: " << statusStr << std::endl;
+    
+    // 2. LOG FILES SECTION
+    report << "\n[LOG FILES]" << std::endl;
+    report << "Data files: " << logResult.dataFileCount << " found | " 
+           << (logResult.flags & FLAG_DATA_MISSING ? "NONE" : 
+              (logResult.flags & FLAG_DATA_EMPTY) ? "SOME EMPTY" :
+              (logResult.flags & FLAG_DATA_INVALID) ? "SOME INVALID" : "VALID") << std::endl;
+    report << "Non-empty files: " << logResult.nonEmptyDataCount << "/" << logResult.dataFileCount << std::endl;
+    report << "Valid files: " << logResult.validDataCount << "/" << logResult.dataFileCount << std::endl;
+    report << "Tester FEB files: " << (logResult.foundFebFile ? "MATCHED" : "UNMATCHED") << std::endl;
+    report << "Log file: " << (logResult.logExists ? "FOUND" : "MISSING") << std::endl;
+    
+    // 2a. Empty log files
+    if (!logResult.emptyFiles.empty()) {
+        report << "\nEmpty log data files:" << std::endl;
+        for (const auto& file : logResult.emptyFiles) {
+            report << " - " << file << std::endl;
+        }
+    }
+    
+    // 2b. Invalid log files
+    if (!logResult.invalidFiles.empty()) {
+        report << "\nInvalid log data files:" << std::endl;
+        for (const auto& file : logResult.invalidFiles) {
+            report << " - " << file << std::endl;
+        }
+    }
+    
+    // 3. TRIM FILES SECTION
+    report << "\n[TRIM FILES]" << std::endl;
+    report << "Electron files: " << trimResult.electronCount << "/" << kTrimRules.hwCount << std::endl;
+    report << "Hole files: " << trimResult.holeCount << "/" << kTrimRules.hwCount << std::endl;
+    
+    // 3a. Empty trim files
+    if (!trimResult.emptyFiles.empty()) {
+        report << "\nEmpty trim files:" << std::endl;
+        for (const auto& file : trimResult.emptyFiles) {
+            report << " - " << file << std::endl;
+        }
+    }
+    
+    // 4. PSCAN FILES SECTION
+    report << "\n[PSCAN FILES]" << std::endl;
+    report << "Electron text: " << pscanResult.electronTxtCount << "/" << kPscanRules.hwCount << std::endl;
+    report << "Hole text: " << pscanResult.holeTxtCount << "/" << kPscanRules.hwCount << std::endl;
+    report << "Electron root: " << pscanResult.electronRootCount << "/" << kPscanRules.hwCount << std::endl;
+    report << "Hole root: " << pscanResult.holeRootCount << "/" << kPscanRules.hwCount << std::endl;
+    report << "Module files: " << (pscanResult.flags & (FLAG_MODULE_ROOT|FLAG_MODULE_TXT|FLAG_MODULE_PDF) ? "ERROR" : "OK") << std::endl;
+    
+    // 4a. Empty pscan files
+    if (!pscanResult.emptyFiles.empty()) {
+        report << "\nEmpty pscan files:" << std::endl;
+        for (const auto& file : pscanResult.emptyFiles) {
+            report << " - " << file << std::endl;
+        }
+    }
+    
+    // 4b. Module file errors
+    if (!pscanResult.moduleErrorFiles.empty()) {
+        report << "\nModule test file errors:" << std::endl;
+        for (const auto& file : pscanResult.moduleErrorFiles) {
+            report << " - " << file << std::endl;
+        }
+    }
+    
+    // 5. CONNECTION FILES SECTION
+    report << "\n[CONNECTION FILES]" << std::endl;
+    report << "Electron files: " << connResult.electronCount << "/" << kConnRules.hwCount << std::endl;
+    report << "Hole files: " << connResult.holeCount << "/" << kConnRules.hwCount << std::endl;
+    
+    if (!connResult.emptyFiles.empty()) {
+        report << "\nEmpty connection files:" << std::endl;
+        for (const auto& file : connResult.emptyFiles) {
+            report << " - " << file << std::endl;
+        }
+    }
+    
+    // ===================================================================
+    // ERROR SUMMARY SECTION
+    // ===================================================================
+    
+    // 6. FILE OPEN ERRORS (combined from all validations)
+    if (!logResult.openErrorFiles.empty() || !trimResult.openErrorFiles.empty() ||
+        !pscanResult.openErrorFiles.empty() || !connResult.openErrorFiles.empty()) {
+        report << "\n[FILE OPEN ERRORS]" << std::endl;
+        
+        if (!logResult.openErrorFiles.empty()) {
+            report << "Log file errors:" << std::endl;
+            for (const auto& file : logResult.openErrorFiles) report << "  - " << file << std::endl;
+        }
+        if (!trimResult.openErrorFiles.empty()) {
+            report << "Trim file errors:" << std::endl;
+            for (const auto& file : trimResult.openErrorFiles) report << "  - " << file << std::endl;
+        }
+        if (!pscanResult.openErrorFiles.empty()) {
+            report << "Pscan file errors:" << std::endl;
+            for (const auto& file : pscanResult.openErrorFiles) report << "  - " << file << std::endl;
+        }
+        if (!connResult.openErrorFiles.empty()) {
+            report << "Connection file errors:" << std::endl;
+            for (const auto& file : connResult.openErrorFiles) report << "  - " << file << std::endl;
+        }
+    }
+    
+    // 7. UNEXPECTED FILES (combined from all validations)
+    if (!logResult.unexpectedFiles.empty() || !trimResult.unexpectedFiles.empty() ||
+        !pscanResult.unexpectedFiles.empty() || !connResult.unexpectedFiles.empty()) {
+        report << "\n[UNEXPECTED FILES]" << std::endl;
+        
+        if (!logResult.unexpectedFiles.empty()) {
+            report << "Log directory unexpected files:" << std::endl;
+            for (const auto& file : logResult.unexpectedFiles) report << "  - " << file << std::endl;
+        }
+        if (!trimResult.unexpectedFiles.empty()) {
+            report << "Trim directory unexpected files:" << std::endl;
+            for (const auto& file : trimResult.unexpectedFiles) report << "  - " << file << std::endl;
+        }
+        if (!pscanResult.unexpectedFiles.empty()) {
+            report << "Pscan directory unexpected files:" << std::endl;
+            for (const auto& file : pscanResult.unexpectedFiles) report << "  - " << file << std::endl;
+        }
+        if (!connResult.unexpectedFiles.empty()) {
+            report << "Connection directory unexpected files:" << std::endl;
+            for (const auto& file : connResult.unexpectedFiles) report << "  - " << file << std::endl;
+        }
+    }
+    
+    return report.str();
+}
+
+/*
+ * Directory Summary Columns:
+ * Flat numeric view of one directory's results, shared by the ROOT
+ * Directories tree and the JSON/CSV streams. Boolean columns are 0/1;
+ * n* columns count problem files over all four checks.
+ */
+constexpr const char* kSummaryColumns[] = {
+    "status", "logFlags", "trimFlags", "pscanFlags", "connFlags",
+    "logExists", "foundFebFile", "dataFileCount", "nonEmptyDataCount", "validDataCount",
+    "trimElectronCount", "trimHoleCount",
+    "pscanElectronTxtCount", "pscanHoleTxtCount", "pscanElectronRootCount", "pscanHoleRootCount",
+    "connElectronCount", "connHoleCount",
+    "nOpenErrorFiles", "nUnexpectedFiles", "nEmptyFiles", "nInvalidFiles", "nModuleErrorFiles"
+};
+constexpr int kNSummaryColumns = sizeof(kSummaryColumns) / sizeof(kSummaryColumns[0]);
+
+/*
+ * DirectorySummary Structure:
+ * One row of the summary columns
+ */
+struct DirectorySummary {
+    std::string dirName;                          // Directory name
+    std::string statusText;                       // Human-readable status
+    std::array<Int_t, kNSummaryColumns> values{}; // In kSummaryColumns order
+};
+
+/*
+ * SummarizeDirectory:
+ * Fills the summary columns of a validated directory
+ */
+DirectorySummary SummarizeDirectory(const DirectoryValidation& validation) {
+    const ValidationResult& logResult = validation.logResult;
+    const ValidationResult& trimResult = validation.trimResult;
+    const ValidationResult& pscanResult = validation.pscanResult;
+    const ValidationResult& connResult = validation.connResult;
+
+    DirectorySummary summary;
+    summary.dirName = validation.dirName.Data();
+    int status = EvaluateDirectoryStatus(validation, summary.statusText);
+
+    int nFiles[5] = {0, 0, 0, 0, 0};
+    for (const ValidationResult* result : {&logResult, &trimResult, &pscanResult, &connResult}) {
+        nFiles[0] += result->openErrorFiles.size();
+        nFiles[1] += result->unexpectedFiles.size();
+        nFiles[2] += result->emptyFiles.size();
+        nFiles[3] += result->invalidFiles.size();
+        nFiles[4] += result->moduleErrorFiles.size();
+    }
+
+    summary.values = {
+        status, logResult.flags, trimResult.flags, pscanResult.flags, connResult.flags,
+        logResult.logExists, logResult.foundFebFile,
+        logResult.dataFileCount, logResult.nonEmptyDataCount, logResult.validDataCount,
+        trimResult.electronCount, trimResult.holeCount,
+        pscanResult.electronTxtCount, pscanResult.holeTxtCount,
+        pscanResult.electronRootCount, pscanResult.holeRootCount,
+        connResult.electronCount, connResult.holeCount,
+        nFiles[0], nFiles[1], nFiles[2], nFiles[3], nFiles[4]
+    };
+    return summary;
+}
+
+/*
+ * JsonEscape:
+ * Quotes a string for JSON output
+ */
+std::string JsonEscape(std::string_view text) {
+    std::string escaped = "\"";
+    for (unsigned char c : text) {
+        switch (c) {
+            case '"':  escaped += "\\\""; break;
+            case '\\': escaped += "\\\\"; break;
+            case '\n': escaped += "\\n"; break;
+            case '\t': escaped += "\\t"; break;
+            default:
+                if (c < 0x20) {
+                    escaped += TString::Format("\\u%04x", c).Data();
+                } else {
+                    escaped += c;
+                }
+        }
+    }
+    return escaped + "\"";
+}
+
+/*
+ * CsvEscape:
+ * Quotes a CSV field when it contains a separator, quote or line break
+ */
+std::string CsvEscape(std::string_view text) {
+    if (text.find_first_of(",\"\n\r") == std::string_view::npos) return std::string(text);
+    std::string escaped = "\"";
+    for (char c : text) {
+        if (c == '"') escaped += '"';
+        escaped += c;
+    }
+    return escaped + "\"";
+}
+
+/*
+ * ResultStream:
+ * Streaming machine-readable output of a validation pass. Every directory
+ * is written (and flushed) as one JSON Lines record and/or CSV row when it
+ * is merged, so dashboards can follow a run live and nothing accumulates.
+ */
+class ResultStream {
+public:
+    // Opens <baseName>.jsonl / .csv for the FORMAT_JSON / FORMAT_CSV bits of formats
+    ResultStream(const TString& baseName, int formats) {
+        if (formats & FORMAT_JSON) {
+            jsonName = std::string(baseName.Data()) + ".jsonl";
+            profileName = std::string(baseName.Data()) + "_profile.json";
+            json.open(jsonName);
+            if (!json.is_open()) {
+                std::cerr << "Error: Could not open report file for writing: " << jsonName << std::endl;
+                jsonName.clear();
+            }
+        }
+        if (formats & FORMAT_CSV) {
+            csvName = std::string(baseName.Data()) + ".csv";
+            csv.open(csvName);
+            if (!csv.is_open()) {
+                std::cerr << "Error: Could not open report file for writing: " << csvName << std::endl;
+                csvName.clear();
+            } else {
+                csv << "ladder,dirName,statusText";
+                for (int i = 0; i < kNSummaryColumns; i++) csv << "," << kSummaryColumns[i];
+                csv << "\n";
+            }
+        }
+    }
+
+    // Writes one directory (summary columns plus problem file lists in JSON)
+    void Write(const std::string& ladder, const DirectoryValidation& validation,
+               const DirectorySummary& summary) {
+        if (json.is_open()) {
+            json << "{\"ladder\":" << JsonEscape(ladder)
+                 << ",\"dirName\":" << JsonEscape(summary.dirName)
+                 << ",\"statusText\":" << JsonEscape(summary.statusText);
+            for (int i = 0; i < kNSummaryColumns; i++) {
+                json << ",\"" << kSummaryColumns[i] << "\":" << summary.values[i];
+            }
+
+            // Non-empty problem file lists: "files":{"pscan":{"empty":[...]}}
+            const char* checkNames[4] = {"log", "trim", "pscan", "conn"};
+            const ValidationResult* results[4] = {&validation.logResult, &validation.trimResult,
+                                                  &validation.pscanResult, &validation.connResult};
+            json << ",\"files\":{";
+            bool firstCheck = true;
+            for (int c = 0; c < 4; c++) {
+                const std::pair<const char*, const NameList*> lists[5] = {
+                    {"openError", &results[c]->openErrorFiles},
+                    {"empty", &results[c]->emptyFiles},
+                    {"invalid", &results[c]->invalidFiles},
+                    {"unexpected", &results[c]->unexpectedFiles},
+                    {"moduleError", &results[c]->moduleErrorFiles}
+                };
+                bool firstList = true;
+                for (const auto& list : lists) {
+                    if (list.second->empty()) continue;
+                    json << (firstList ? (firstCheck ? "" : ",") : ",");
+                    if (firstList) json << "\"" << checkNames[c] << "\":{";
+                    json << "\"" << list.first << "\":[";
+                    for (size_t f = 0; f < list.second->size(); f++) {
+                        json << (f ? "," : "") << JsonEscape((*list.second)[f]);
+                    }
+                    json << "]";
+                    firstList = false;
+                }
+                if (!firstList) {
+                    json << "}";
+                    firstCheck = false;
+                }
+            }
+            json << "}}" << std::endl;  // One flushed line per directory
+        }
+
+        if (csv.is_open()) {
+            csv << CsvEscape(ladder) << "," << CsvEscape(summary.dirName) << ","
+                << CsvEscape(summary.statusText);
+            for (int i = 0; i < kNSummaryColumns; i++) csv << "," << summary.values[i];
+            csv << std::endl;
+        }
+    }
+
+    // Closes the files and reports where they were written. Next to the
+    // JSON Lines report the run profile is written to <baseName>_profile.json:
+    // {"profile":[...],"slowestFiles":[...]}
+    void Close() {
+        if (json.is_open()) {
+            json.close();
+            std::cout << "JSON Lines report saved to: " << jsonName << std::endl;
+            SaveProfile();
+        }
+        if (csv.is_open()) {
+            csv.close();
+            std::cout << "CSV report saved to: " << csvName << std::endl;
+        }
+    }
+
+private:
+    // Stage counters and slowest files, as one JSON object
+    void SaveProfile() {
+        std::ofstream out(profileName);
+        if (!out.is_open()) {
+            std::cerr << "Error: Could not open report file for writing: " << profileName << std::endl;
+            return;
+        }
+        out << "{\"profile\":[";
+        for (int i = 0; i < STAGE_COUNT; i++) {
+            const StageCounters& stage = gProfile.stages[i];
+            out << (i ? "," : "") << "{\"stage\":\"" << kStageNames[i] << "\",\"calls\":" << stage.calls
+                << ",\"seconds\":" << TString::Format("%.6f", stage.wallNs * 1e-9)
+                << ",\"files\":" << stage.files << ",\"bytes\":" << stage.bytes
+                << ",\"ioCalls\":" << stage.ioCalls << "}";
+        }
+        out << "],\"slowestFiles\":[";
+        {
+            std::lock_guard<std::mutex> lock(gProfile.slowestMutex);
+            for (size_t i = 0; i < gProfile.slowest.size(); i++) {
+                const SlowFile& file = gProfile.slowest[i];
+                out << (i ? "," : "") << "{\"stage\":" << JsonEscape(file.stage)
+                    << ",\"file\":" << JsonEscape(file.path)
+                    << ",\"seconds\":" << TString::Format("%.6f", file.seconds) << "}";
+            }
+        }
+        out << "]}" << std::endl;
+        std::cout << "Run profile saved to: " << profileName << std::endl;
+    }
+
+    std::ofstream json, csv;
+    std::string jsonName, csvName, profileName;
+};
+
+/*
+ * OpenResultStream:
+ * Streaming output for a validation pass, nullptr unless json or csv
+ * output was requested
+ */
+std::shared_ptr<ResultStream> OpenResultStream(const TString& baseName) {
+    if (!(gOptions.formats & FORMAT_STREAMS)) return nullptr;
+    return std::make_shared<ResultStream>(baseName, gOptions.formats);
+}
+
+/*
+ * RecordDirectoryValidation:
+ * Evaluates a validated directory and merges it into the global state
+ *
+ * Effects (on state, gState by default):
+ * - Updates the status counters
+ * - Writes the directory to the JSON/CSV stream, if any
+ * - Adds formatted report to reportPages (txt/root/pdf output only)
+ * - Stores the results in results for the cleanup step
+ */
+void RecordDirectoryValidation(DirectoryValidation validation, GlobalState& state = gState) {
+    std::string statusStr;
+    int dirStatus = EvaluateDirectoryStatus(validation, statusStr);
+
+    // The formatted page is only needed by the txt/root/pdf reports
+    std::string page;
+    if (gOptions.formats & FORMAT_PAGES) {
+        page = BuildReportPage(validation, statusStr);
+    }
+
+    std::lock_guard<std::mutex> lock(gStateMutex);
+    if (state.stream) {
+        ScopedStage stage(STAGE_REPORT_STREAM);
+        state.stream->Write(state.currentLadder, validation, SummarizeDirectory(validation));
+    }
+    if (state.journal) state.journal->Append(validation);
+    switch (dirStatus) {
+        case STATUS_DATA_CONSISTENT:
+            state.goodDirs++;
+            break;
+        case STATUS_DATA_INCONSISTENT_AUXILIARY:
+            state.auxDirs++;
+            break;
+        case STATUS_DATA_INCONSISTENT_MISSING_EXTRA:
+            state.missextraDirs++;
+            break;
+        case STATUS_DIRECTORY_ERROR:
+            state.errorDirs++;
+            break;
+    }
+    if (gOptions.formats & FORMAT_PAGES) {
+        state.reportPages.push_back(std::move(page));
+    }
+    state.results.push_back(std::move(validation));
+}
+
+/*
+ * GenerateReportPage:
+ * Creates a detailed validation report for a single test directory by combining results
+ * from all validation checks (log, trim, pscan, and connection files).
+ * 
+ * Parameters:
+ *   dirName - Name of the directory being validated
+ * 
+ * Effects:
+ * - Runs all four validation functions
+ * - Determines overall directory status
+ * - Updates global counters
+ * - Adds formatted report to gState.reportPages
+ */
+void GenerateReportPage(const TString& dirName) {
+    RecordDirectoryValidation(ValidateDirectory(dirName, gSystem->pwd()));
+}
+
+/*
+ * SaveTxtReport:
+ * Generates and saves a complete text report containing all validation results
+ * to a specified file. Includes both individual directory reports and global summary.
+ *
+ * Parameters:
+ *   filename - Full path of the output text file to create/overwrite
+ *   state    - Ladder state to report (default: gState)
+ *
+ * Operation:
+ * 1. Creates/overwrites the specified text file
+ * 2. Writes a standardized report header with metadata
+ * 3. Outputs all individual directory reports
+ * 4. Appends the global summary statistics
+ * 5. Closes the file with proper error handling
+ *
+ * Output Format:
+ * - Plain ASCII text with clear section headers
+ * - Fixed-width formatting for alignment
+ * - Human-readable status indicators
+ */
+void SaveTxtReport(const TString& filename, const GlobalState& state = gState) {
+    ScopedStage stage(STAGE_REPORT_TXT);
+    CountFile();
+    // Attempt to open the output file
+    std::ofstream out(filename.Data());
+    
+    // ===================================================================
+    // FILE OPENING VALIDATION
+    // ===================================================================
+    if (!out.is_open()) {
+        std::cerr << "Error: Could not open report file for writing: " << filename << std::endl;
+        return;
+    }
+
+    // ===================================================================
+    // REPORT HEADER SECTION
+    // ===================================================================
+    /* Standardized header with metadata */
+    out << "=======================================================\n";
+    out << "      EXORCISM VALIDATION REPORT - TEXT VERSION\n";
+    out << "=======================================================\n\n";
+    
+    // System and timing information
+    out << "Ladder: " << state.currentLadder << "\n";
+    out << "Report generated: " << FormatCurrentTime("%b %e %Y %H:%M:%S") << "\n";
+    out << "Total directories processed: " 
+        << (state.goodDirs + state.auxDirs + state.missextraDirs+state.errorDirs) << "\n";
+    out << "-------------------------------------------------------\n\n";
+
+    // ===================================================================
+    // INDIVIDUAL DIRECTORY REPORTS
+    // ===================================================================
+    /* Write each directory's report in sequence */
+    for (size_t i = 0; i < state.reportPages.size(); i++) {
+        // Add separator between reports
+        if (i > 0) {
+            out << "\n\n";
+            out << "=======================================================\n";
+            out << "              NEXT DIRECTORY REPORT\n";
+            out << "=======================================================\n\n";
+        }
+        
+        // Write the actual report content
+        out << state.reportPages[i];
+    }
+
+    // ===================================================================
+    // GLOBAL SUMMARY SECTION
+    // ===================================================================
+    /* Final consolidated statistics */
+    out << "\n\n";
+    out << "=======================================================\n";
+    out << "                 VALIDATION SUMMARY\n";
+    out << "=======================================================\n\n";
+    
+    // Calculate success rate (handling division by zero)
+    int totalDirs = state.goodDirs + state.auxDirs + state.missextraDirs+state.errorDirs;
+    float successRate = (totalDirs > 0) ? 
+        (100.0f * (state.goodDirs + state.auxDirs) / totalDirs) : 0.0f;
+
+    // Summary statistics
+    out << "Directories with consistent data: " << state.goodDirs << "\n";
+    out << "Directories with inconsistent data (auxiliary files found): " << state.auxDirs << "\n";
+    out << "Directories with inconsistent data (missing/extra files): " << state.missextraDirs << "\n";
+    out << "Directories with access errors: " << state.errorDirs << "\n";
+    out << "Overall success rate: " << std::fixed << std::setprecision(1) 
+        << successRate << "%\n\n";
+    
+    // Add any additional global summary content
+    if (!state.globalSummary.empty()) {
+        out << state.globalSummary << "\n";
+    }
+
+    // ===================================================================
+    // REPORT FOOTER
+    // ===================================================================
+    out << "=======================================================\n";
+    out << "                 END OF REPORT\n";
+    out << "=======================================================\n";
+
+    // ===================================================================
+    // FILE CLOSING AND CONFIRMATION
+    // ===================================================================
+    out.close();
+    
+    // Verify successful write operation
+    if (out.fail()) {
+        std::cerr << "Warning: Potential write error during report generation: " 
+                  << filename << std::endl;
+    } else {
+        std::cout << "Text report successfully saved to: " << filename << std::endl;
+    }
+}
+
+/*
+ * WriteDirectoriesTree:
+ * Writes the "Directories" TTree into the current ROOT file: one entry per
+ * directory with its status and all columns of DirectorySummary
+ */
+void WriteDirectoriesTree(const GlobalState& state) {
+    TTree tree("Directories", "EXORCISM per-directory validation results");
+
+    DirectorySummary row;
+    tree.Branch("dirName", &row.dirName);
+    tree.Branch("statusText", &row.statusText);
+    for (int i = 0; i < kNSummaryColumns; i++) {
+        tree.Branch(kSummaryColumns[i], &row.values[i], TString::Format("%s/I", kSummaryColumns[i]));
+    }
+
+    for (const auto& validation : state.results) {
+        row = SummarizeDirectory(validation);
+        tree.Fill();
+    }
+
+    if (tree.Write() == 0) {
+        std::cerr << "Warning: Failed to write Directories tree to ROOT file" << std::endl;
+    }
+}
+
+/*
+ * ForEachProblemFile:
+ * Calls visit(dirIndex, validation, check, category, file) for every
+ * problem file of state, in the order of the "Files" tree
+ */
+template <typename F>
+void ForEachProblemFile(const GlobalState& state, F visit) {
+    const char* checkNames[4] = {"log", "trim", "pscan", "conn"};
+    for (size_t i = 0; i < state.results.size(); i++) {
+        const DirectoryValidation& validation = state.results[i];
+        const ValidationResult* results[4] = {&validation.logResult, &validation.trimResult,
+                                              &validation.pscanResult, &validation.connResult};
+        for (int c = 0; c < 4; c++) {
+            const std::pair<const char*, const NameList*> lists[5] = {
+                {"openError", &results[c]->openErrorFiles},
+                {"empty", &results[c]->emptyFiles},
+                {"invalid", &results[c]->invalidFiles},
+                {"unexpected", &results[c]->unexpectedFiles},
+                {"moduleError", &results[c]->moduleErrorFiles}
+            };
+            for (const auto& list : lists) {
+                for (const auto& name : *list.second) {
+                    visit((int)i, validation, checkNames[c], list.first, name);
+                }
+            }
+        }
+    }
+}
+
+/*
+ * WriteFilesTree:
+ * Writes the "Files" TTree into the current ROOT file: one entry per
+ * problem file (open error, empty, invalid, unexpected, module error)
+ */
+void WriteFilesTree(const GlobalState& state) {
+    TTree tree("Files", "EXORCISM problem files");
+
+    Int_t dirIndex = 0;
+    std::string dirName, check, category, file;
+    tree.Branch("dirIndex", &dirIndex, "dirIndex/I");  // Entry in the Directories tree
+    tree.Branch("dirName", &dirName);
+    tree.Branch("check", &check);        // log, trim, pscan or conn
+    tree.Branch("category", &category);  // openError, empty, invalid, unexpected or moduleError
+    tree.Branch("file", &file);
+
+    ForEachProblemFile(state, [&](int index, const DirectoryValidation& validation, const char* checkName,
+                                  const char* categoryName, std::string_view name) {
+        dirIndex = index;
+        dirName = validation.dirName.Data();
+        check = checkName;
+        category = categoryName;
+        file = name;
+        tree.Fill();
+    });
+
+    if (tree.Write() == 0) {
+        std::cerr << "Warning: Failed to write Files tree to ROOT file" << std::endl;
+    }
+}
+
+/*
+ * WriteProfileTrees:
+ * Writes the instrumentation of the run so far into the current ROOT file:
+ * "Profile" (one entry per stage) and "SlowestFiles"
+ */
+void WriteProfileTrees() {
+    TTree profile("Profile", "EXORCISM per-stage timing and I/O counters");
+    std::string stageName;
+    Long64_t calls = 0, files = 0, bytes = 0, ioCalls = 0;
+    Double_t seconds = 0;
+    profile.Branch("stage", &stageName);
+    profile.Branch("calls", &calls, "calls/L");
+    profile.Branch("seconds", &seconds, "seconds/D");
+    profile.Branch("files", &files, "files/L");
+    profile.Branch("bytes", &bytes, "bytes/L");
+    profile.Branch("ioCalls", &ioCalls, "ioCalls/L");
+    for (int i = 0; i < STAGE_COUNT; i++) {
+        const StageCounters& stage = gProfile.stages[i];
+        stageName = kStageNames[i];
+        calls = stage.calls;
+        seconds = stage.wallNs * 1e-9;
+        files = stage.files;
+        bytes = stage.bytes;
+        ioCalls = stage.ioCalls;
+        profile.Fill();
+    }
+
+    TTree slowestTree("SlowestFiles", "EXORCISM slowest file checks");
+    std::string path;
+    slowestTree.Branch("stage", &stageName);
+    slowestTree.Branch("file", &path);
+    slowestTree.Branch("seconds", &seconds, "seconds/D");
+    {
+        std::lock_guard<std::mutex> lock(gProfile.slowestMutex);
+        for (const auto& file : gProfile.slowest) {
+            stageName = file.stage;
+            path = file.path;
+            seconds = file.seconds;
+            slowestTree.Fill();
+        }
+    }
+
+    if (profile.Write() == 0 || slowestTree.Write() == 0) {
+        std::cerr << "Warning: Failed to write profile trees to ROOT file" << std::endl;
+    }
+}
+
+/*
+ * SaveRootReport:
+ * Saves all validation reports to a ROOT file format for programmatic analysis.
+ * Stores each directory report as a separate TObjString and includes summary statistics.
+ * The same results are stored as TTrees for columnar queries.
+ *
+ * Parameters:
+ *   filename - Full path of the output ROOT file to create/overwrite
+ *   state    - Ladder state to report (default: gState)
+ *
+ * Operation:
+ * 1. Creates a new ROOT file (overwrites existing)
+ * 2. Saves each directory report as a named TObjString
+ * 3. Stores global summary as a separate object
+ * 4. Writes the Directories and Files trees
+ * 5. Ensures proper file closure and error handling
+ *
+ * ROOT File Structure:
+ * - Contains TObjString objects for each directory report
+ * - Includes "GlobalSummary" TObjString
+ * - Objects named systematically (Directory_0, Directory_1, etc.)
+ * - "Directories" TTree: status, flags and counters, one entry per directory
+ * - "Files" TTree: one entry per problem file
+ */
+void SaveRootReport(const TString& filename, const GlobalState& state = gState) {
+    ScopedStage stage(STAGE_REPORT_ROOT);
+    CountFile();
+    // ===================================================================
+    // FILE CREATION AND VALIDATION
+    // ===================================================================
+    /* Create the ROOT file (RECREATE mode overwrites existing) */
+    TFile file(filename, "RECREATE");
+    
+    // Verify file was created successfully
+    if (file.IsZombie()) {
+        std::cerr << "Error: Could not create ROOT report file: " << filename << std::endl;
+        return;
+    }
+
+    // ===================================================================
+    // STORE INDIVIDUAL DIRECTORY REPORTS
+    // ===================================================================
+    /* Save each directory report as a separate named object */
+    for (size_t i = 0; i < state.reportPages.size(); i++) {
+        // Create object name with index (Directory_0, Directory_1, etc.)
+        TString name = TString::Format("Directory_%zu", i);
+        
+        // Create a ROOT string object containing the report
+        TObjString obj(state.reportPages[i].c_str());
+        
+        // Write to file and check for errors
+        if (obj.Write(name) == 0) {
+            std::cerr << "Warning: Failed to write directory report " << i 
+                      << " to ROOT file" << std::endl;
+        }
+    }
+
+    // ===================================================================
+    // STORE GLOBAL SUMMARY
+    // ===================================================================
+    /* Save the consolidated summary as a special object */
+    TObjString summary(state.globalSummary.c_str());
+    if (summary.Write("GlobalSummary") == 0) {
+        std::cerr << "Warning: Failed to write global summary to ROOT file" << std::endl;
+    }
+
+    // ===================================================================
+    // STORE STRUCTURED RESULTS
+    // ===================================================================
+    WriteDirectoriesTree(state);
+    WriteFilesTree(state);
+    WriteProfileTrees();
+
+    // ===================================================================
+    // FILE FINALIZATION
+    // ===================================================================
+    /* Properly close the file and handle any errors */
+    file.Close();
+    
+    // Verify write operation was successful
+    if (file.TestBit(TFile::kWriteError)) {
+        std::cerr << "Warning: Potential write error during ROOT file creation: " 
+                  << filename << std::endl;
+    } else {
+        std::cout << "ROOT report successfully saved to: " << filename << std::endl;
+        
+        // Optional: Print file size for verification
+        Long64_t size = file.GetSize();
+        std::cout << "File size: " << size << " bytes" << std::endl;
+    }
+}
+
+/*
+ * PdfReportFunction:
+ * Signature of ExorcismSavePdfReport() in the PDF plugin (ExorcismPdf.C)
+ */
+typedef int (*PdfReportFunction)(const char* filename, const char* ladder, const char* generated,
+                                 const int* dirCounts, const char* const* pages, int nPages,
+                                 int summaryOnly);
+
+/*
+ * LoadPdfPlugin:
+ * Resolves the PDF renderer on first use, so the ROOT graphics libraries
+ * are only loaded when a PDF report is actually written.
+ * - ROOT macro: interprets ExorcismPdf.C from the directory of this macro
+ * - Executable: opens libExorcismPdf.so next to the binary, in ../lib
+ *   or on LD_LIBRARY_PATH
+ * Returns nullptr (after reporting why) if the plugin is unavailable.
+ */
+PdfReportFunction LoadPdfPlugin() {
+    static PdfReportFunction function = nullptr;
+    static bool attempted = false;
+    if (attempted) return function;
+    attempted = true;
+
+#ifdef __CLING__
+    TString macro = gSystem->GetDirName(__FILE__) + "/ExorcismPdf.C";
+    int error = 0;
+    gROOT->LoadMacro(macro, &error);
+    if (error == 0) {
+        function = (PdfReportFunction)gInterpreter->Calc("(long)&ExorcismSavePdfReport");
+    }
+    if (!function) {
+        std::cerr << "Error: Cannot load PDF plugin: " << macro << std::endl;
+    }
+#else
+    void* handle = dlopen("libExorcismPdf.so", RTLD_NOW | RTLD_LOCAL);
+    if (handle) {
+        function = (PdfReportFunction)dlsym(handle, "ExorcismSavePdfReport");
+    }
+    if (!function) {
+        std::cerr << "Error: Cannot load PDF plugin: " << dlerror() << std::endl;
+    }
+#endif
+    return function;
+}
+
+/*
+ * PdfJob Structure:
+ * Copy of everything the PDF plugin needs, owned by the PDF thread
+ */
+struct PdfJob {
+    std::string filename;                  // Output file
+    std::string ladder;                    // Ladder name
+    std::string generated;                 // Report generation time
+    int dirCounts[4] = {0, 0, 0, 0};       // Good, auxiliary, missing/extra, error
+    std::vector<std::string> pages;        // Directory report pages
+    bool summaryOnly = false;              // Summary page and directory index only
+};
+
+/*
+ * PendingPdfReport Structure:
+ * PDF report queued on the PDF thread
+ */
+struct PendingPdfReport {
+    TString filename;           // Output file
+    std::future<int> rendered;  // Plugin result (1 = written)
+};
+
+std::vector<PendingPdfReport> gPendingPdfReports;  // Collected by WaitForPdfReports()
+bool gPdfWasBatch = false;  // Batch mode before the first queued PDF report
+
+/*
+ * PdfThread:
+ * Single background thread rendering the queued PDF reports in order
+ */
+ThreadPool& PdfThread() {
+    static ThreadPool thread(1);
+    return thread;
+}
+
+/*
+ * SavePdfReport:
+ * Queues the graphical PDF report (summary page with pie chart and
+ * one color-coded page per directory, or a compact directory index with
+ * --pdf=summary) for the PDF plugin. Rendering runs on the PDF thread
+ * while the caller goes on with the other reports and the cleanup;
+ * WaitForPdfReports() collects the results. The report pages are
+ * moved into the render job, leaving state.reportPages empty.
+ *
+ * Parameters:
+ *   filename - Full path of the output PDF file
+ *   state    - Ladder state to report (default: gState)
+ */
+void SavePdfReport(const TString& filename, GlobalState& state = gState) {
+    PdfReportFunction render = LoadPdfPlugin();  // Loaded here: interpreter access stays on this thread
+    if (!render) {
+        std::cerr << "Warning: PDF report not written: " << filename << std::endl;
+        return;
+    }
+
+    auto job = std::make_shared<PdfJob>();
+    job->filename = filename.Data();
+    job->ladder = state.currentLadder;
+    job->generated = FormatCurrentTime("%b %e %Y %H:%M:%S");
+    job->dirCounts[0] = state.goodDirs;
+    job->dirCounts[1] = state.auxDirs;
+    job->dirCounts[2] = state.missextraDirs;
+    job->dirCounts[3] = state.errorDirs;
+    job->pages = std::move(state.reportPages);
+    job->summaryOnly = gOptions.pdfSummaryOnly;
+
+    static bool threadSafe = false;
+    if (!threadSafe) {
+        ROOT::EnableThreadSafety();  // Canvas drawing next to TFile use on this thread
+        threadSafe = true;
+    }
+
+    // The reports are never shown on screen: canvases need no display backend.
+    // Switched here, since the PDF thread must not change global ROOT state.
+    if (gPendingPdfReports.empty()) {
+        gPdfWasBatch = gROOT->IsBatch();
+        gROOT->SetBatch(kTRUE);
+    }
+
+    PendingPdfReport pending;
+    pending.filename = filename;
+    pending.rendered = PdfThread().Submit([render, job]() {
+        ScopedStage stage(STAGE_REPORT_PDF);
+        CountFile();
+        std::vector<const char*> pages;
+        pages.reserve(job->pages.size());
+        for (const auto& page : job->pages) {
+            pages.push_back(page.c_str());
+        }
+        return render(job->filename.c_str(), job->ladder.c_str(), job->generated.c_str(),
+                      job->dirCounts, pages.data(), (int)pages.size(), job->summaryOnly);
+    });
+    gPendingPdfReports.push_back(std::move(pending));
+}
+
+/*
+ * WaitForPdfReports:
+ * Waits for all queued PDF reports, prints where they were saved and
+ * restores the batch mode SavePdfReport() switched on
+ */
+void WaitForPdfReports() {
+    if (gPendingPdfReports.empty()) return;
+    for (auto& pending : gPendingPdfReports) {
+        if (pending.rendered.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            std::cout << "Waiting for PDF report: " << pending.filename << std::endl;
+        }
+        if (pending.rendered.get()) {
+            std::cout << "PDF report saved to: " << pending.filename << std::endl;
+        } else {
+            std::cerr << "Error: PDF report could not be written: " << pending.filename << std::endl;
+        }
+    }
+    gPendingPdfReports.clear();
+    gROOT->SetBatch(gPdfWasBatch);
+}
+
+/*
+ * SaveReports:
+ * Writes the current state in every selected output format. The pages
+ * are handed over to the (last) PDF report, so they can't be reused.
+ *
+ * Parameters:
+ *   baseName - Report file name without extension
+ *   state    - Ladder state to report (default: gState)
+ */
+void SaveReports(const TString& baseName, GlobalState& state = gState) {
+    if (gOptions.formats & FORMAT_TXT)  SaveTxtReport(baseName + ".txt", state);
+    if (gOptions.formats & FORMAT_ROOT) SaveRootReport(baseName + ".root", state);
+    if (gOptions.formats & FORMAT_PDF)  SavePdfReport(baseName + ".pdf", state);
+    if (state.stream) state.stream->Close();  // Streamed while validating
+}
+
+/*
+ * PrintReportNames:
+ * Lists the report files written by SaveReports()
+ */
+void PrintReportNames(const TString& baseName) {
+    if (gOptions.formats & FORMAT_TXT)  std::cout << " - Text: " << baseName << ".txt" << std::endl;
+    if (gOptions.formats & FORMAT_ROOT) std::cout << " - ROOT: " << baseName << ".root" << std::endl;
+    if (gOptions.formats & FORMAT_PDF)  std::cout << " - PDF:  " << baseName << ".pdf" << std::endl;
+    if (gOptions.formats & FORMAT_JSON) std::cout << " - JSON: " << baseName << ".jsonl, " << baseName << "_profile.json" << std::endl;
+    if (gOptions.formats & FORMAT_CSV)  std::cout << " - CSV:  " << baseName << ".csv" << std::endl;
+}
+
+/*
+ * GenerateGlobalSummary:
+ * Creates a consolidated summary of all validation results with statistics and metrics.
+ * This global summary appears at the end of reports and provides high-level insights.
+ *
+ * Parameters:
+ *   totalDirs - Total number of directories processed (for percentage calculations)
+ *   state     - Ladder state to summarize (default: gState)
+ *
+ * Operation:
+ * 1. Calculates success rate and other metrics
+ * 2. Formats results into a standardized summary block
+ * 3. Stores the summary in state.globalSummary for inclusion in reports
+ * 4. Outputs the summary to console for immediate feedback
+ *
+ * Output Includes:
+ * - Total directories processed
+ * - Breakdown by status (passed/warning/failed)
+ * - Success rate percentage
+ * - Visual separators for readability
+ */
+void GenerateGlobalSummary(int totalDirs, GlobalState& state = gState) {
+    // Create a string stream to build the summary content
+    std::stringstream summary;
+
+    // ===================================================================
+    // SUMMARY HEADER
+    // ===================================================================
+    summary << "\n\n====================================================\n";
+    summary << "EXORCISM VALIDATION SUMMARY\n";
+    summary << "====================================================\n";
+
+    // ===================================================================
+    // CORE STATISTICS
+    // ===================================================================
+    /* Calculate success rate with protection against division by zero */
+    float successRate = totalDirs > 0 ? 
+        (100.0f * (state.goodDirs + state.auxDirs) / totalDirs) : 0.0f;
+
+    // Basic counts
+    summary << "Ladder:          " << state.currentLadder << "\n";
+    summary << "Total directories:      " << totalDirs << "\n";
+    summary << "Directories with consistent data:    " << state.goodDirs << "\n";
+    summary << "Directories with inconsistent data (auxiliary files found):     " << state.auxDirs << "\n";
+    summary << "Directories with inconsistent data (Missing/Extra files):   " << state.missextraDirs << "\n";
+    summary << "Directories with access errors:     " << state.errorDirs << "\n";
+
+    // Success rate with fixed decimal precision
+    summary << "Success rate:    " << std::fixed << std::setprecision(1) 
+            << successRate << "%\n";
+
+    // ===================================================================
+    // ADDITIONAL METRICS (when applicable)
+    // ===================================================================
+    /* Include warning ratios if there are passed-with-issues cases */
+    if (state.auxDirs > 0) {
+        float warningRate = 100.0f * state.auxDirs / 
+                          (state.goodDirs + state.auxDirs);
+        summary << "Warning rate among passed: " << std::setprecision(1) 
+                << warningRate << "%\n";
+    }
+
+    /* Critical failure analysis */
+    if (state.missextraDirs > 0 || state.errorDirs > 0) {
+        float failureRate = 100.0f * (state.missextraDirs +state.errorDirs)/ totalDirs;
+        summary << "Critical failure rate: " << std::setprecision(1) 
+                << failureRate << "%\n";
+    }
+
+    // ===================================================================
+    // QUALITATIVE ASSESSMENT
+    // ===================================================================
+    summary << "\nOverall Status: ";
+    if (successRate >= 95.0f) {
+        summary << "EXCELLENT (≥95% success)";
+    } 
+    else if (successRate >= 80.0f) {
+        summary << "GOOD (≥80% success)";
+    }
+    else if (successRate >= 60.0f) {
+        summary << "FAIR (≥60% success)";
+    }
+    else {
+        summary << "POOR (<60% success)";
+    }
+
+    // ===================================================================
+    // FOOTER
+    // ===================================================================
+    summary << "\n====================================================\n";
+    summary << "End of Summary\n";
+    summary << "====================================================\n";
+
+    // ===================================================================
+    // STORE AND OUTPUT RESULTS
+    // ===================================================================
+    // Save to global state for inclusion in reports
+    state.globalSummary = summary.str();
+
+    // Also print to console for immediate visibility
+    std::cout << state.globalSummary << std::endl;
+}
+
+/*
+ * WorstStatus:
+ * Highest STATUS_* level among the directories counted in state
+ */
+int WorstStatus(const GlobalState& state) {
+    if (state.errorDirs > 0) return STATUS_DIRECTORY_ERROR;
+    if (state.missextraDirs > 0) return STATUS_DATA_INCONSISTENT_MISSING_EXTRA;
+    if (state.auxDirs > 0) return STATUS_DATA_INCONSISTENT_AUXILIARY;
+    return STATUS_DATA_CONSISTENT;
+}
+
+/*
+ * PrintVerdict:
+ * Prints the ladder (or campaign) verdict for a worst status and returns it
+ */
+int PrintVerdict(int worst) {
+    std::cout << "Verdict: " << (worst <= STATUS_DATA_INCONSISTENT_AUXILIARY ? "SHIPPABLE" : "NOT SHIPPABLE")
+              << " (worst status: " << kStatusNames[worst] << ", exit code " << worst << ")" << std::endl;
+    return worst;
+}
+
+// ===================================================================
+// Delta Report
+// ===================================================================
+
+/*
+ * ReportDigest Structure:
+ * What a delta report compares: the status of every directory and its
+ * problem files, read from a ROOT report or taken from a ladder state
+ */
+struct ReportDigest {
+    std::map<std::string, int> status;   // Directory -> STATUS_* level
+    std::map<std::string, std::set<std::string>> problemFiles;  // Directory -> ProblemFileKey entries
+};
+
+/*
+ * ProblemFileKey:
+ * Entry of ReportDigest::problemFiles, also the line printed for it
+ */
+std::string ProblemFileKey(std::string_view check, std::string_view category, std::string_view file) {
+    std::string key;
+    key.reserve(check.size() + category.size() + file.size() + 3);
+    key.append(check).append(" ").append(category).append(": ").append(file);
+    return key;
+}
+
+/*
+ * DigestState:
+ * Digest of the validated directories of a ladder state
+ */
+ReportDigest DigestState(const GlobalState& state) {
+    ReportDigest digest;
+    for (const auto& validation : state.results) {
+        std::string statusStr;
+        digest.status[validation.dirName.Data()] = EvaluateDirectoryStatus(validation, statusStr);
+    }
+    ForEachProblemFile(state, [&](int, const DirectoryValidation& validation, const char* check,
+                                  const char* category, std::string_view file) {
+        digest.problemFiles[validation.dirName.Data()].insert(ProblemFileKey(check, category, file));
+    });
+    return digest;
+}
+
+/*
+ * LoadReportDigest:
+ * Reads the Directories and Files trees of an earlier ROOT report
+ *
+ * Returns:
+ *   false if the file can't be opened or has no trees (older versions)
+ */
+bool LoadReportDigest(const TString& filename, ReportDigest& digest) {
+    std::unique_ptr<TFile> file(TFile::Open(filename, "READ"));
+    if (!file || file->IsZombie()) {
+        std::cerr << "Error: Could not open previous ROOT report: " << filename << std::endl;
+        return false;
+    }
+    TTree* directories = nullptr;
+    TTree* files = nullptr;
+    file->GetObject("Directories", directories);
+    file->GetObject("Files", files);
+    if (!directories || !files) {
+        std::cerr << "Error: Previous ROOT report has no Directories/Files trees: " << filename << std::endl;
+        return false;
+    }
+
+    // String branches are read into objects allocated by ROOT
+    std::string* dirName = nullptr;
+    std::string* check = nullptr;
+    std::string* category = nullptr;
+    std::string* fileName = nullptr;
+    Int_t status = 0;
+    directories->SetBranchAddress("dirName", &dirName);
+    directories->SetBranchAddress("status", &status);
+    for (Long64_t i = 0; i < directories->GetEntries(); i++) {
+        directories->GetEntry(i);
+        if (dirName) digest.status[*dirName] = status;
+    }
+    directories->ResetBranchAddresses();
+
+    std::string* filesDirName = nullptr;
+    files->SetBranchAddress("dirName", &filesDirName);
+    files->SetBranchAddress("check", &check);
+    files->SetBranchAddress("category", &category);
+    files->SetBranchAddress("file", &fileName);
+    for (Long64_t i = 0; i < files->GetEntries(); i++) {
+        files->GetEntry(i);
+        if (filesDirName && check && category && fileName) {
+            digest.problemFiles[*filesDirName].insert(ProblemFileKey(*check, *category, *fileName));
+        }
+    }
+    files->ResetBranchAddresses();
+
+    delete dirName;
+    delete filesDirName;
+    delete check;
+    delete category;
+    delete fileName;
+    return true;
+}
+
+/*
+ * FindPreviousReport:
+ * Newest ExorcismReport_<ladder>*_before.root in the ladder folder
+ * ("" if there is none)
+ */
+TString FindPreviousReport(const TString& ladderDir, const std::string& ladderName) {
+    std::string prefix = "ExorcismReport_" + ladderName + "_";
+    const FileEntry* newest = nullptr;
+    for (const auto& entry : GetDirectorySnapshot(ladderDir).entries) {
+        if (entry.isDirectory || !HasPrefix(entry.name, prefix) || !HasSuffix(entry.name, "_before.root")) continue;
+        if (!newest || entry.mtime > newest->mtime) newest = &entry;
+    }
+    return newest ? ladderDir + "/" + newest->name.c_str() : TString("");
+}
+
+/*
+ * FormatDelta:
+ * Lists what changed between two digests: directories that started or
+ * stopped failing, other status changes, directories that appeared or
+ * disappeared, and the problem files that are new or gone in directories
+ * present in both
+ */
+std::string FormatDelta(const ReportDigest& previous, const ReportDigest& current) {
+    const std::set<std::string> none;
+    auto filesOf = [&none](const ReportDigest& digest, const std::string& dir) -> const std::set<std::string>& {
+        auto it = digest.problemFiles.find(dir);
+        return it != digest.problemFiles.end() ? it->second : none;
+    };
+
+    std::vector<std::string> failing, fixed, changed, added, removed, newFiles, goneFiles;
+    for (const auto& dir : current.status) {
+        auto old = previous.status.find(dir.first);
+        if (old == previous.status.end()) {
+            added.push_back(dir.first + ": " + kStatusNames[dir.second]);
+            continue;
+        }
+
+        const std::set<std::string>& before = filesOf(previous, dir.first);
+        const std::set<std::string>& after = filesOf(current, dir.first);
+        for (const auto& key : after) {
+            if (!before.count(key)) newFiles.push_back(dir.first + " " + key);
+        }
+        for (const auto& key : before) {
+            if (!after.count(key)) goneFiles.push_back(dir.first + " " + key);
+        }
+
+        if (old->second == dir.second || old->second < 0 || old->second > STATUS_DIRECTORY_ERROR) continue;
+        std::string line = dir.first + ": " + kStatusNames[old->second] + " -> " + kStatusNames[dir.second];
+        if (old->second == STATUS_DATA_CONSISTENT) {
+            failing.push_back(line);
+        } else if (dir.second == STATUS_DATA_CONSISTENT) {
+            fixed.push_back(line);
+        } else {
+            changed.push_back(line);
+        }
+    }
+    for (const auto& dir : previous.status) {
+        if (!current.status.count(dir.first)) removed.push_back(dir.first);
+    }
+
+    std::ostringstream delta;
+    const std::pair<const char*, const std::vector<std::string>*> sections[7] = {
+        {"Newly failing directories", &failing},
+        {"Fixed directories", &fixed},
+        {"Other status changes", &changed},
+        {"New directories", &added},
+        {"Removed directories", &removed},
+        {"New problem files", &newFiles},
+        {"Resolved problem files", &goneFiles}
+    };
+    bool anyChange = false;
+    for (const auto& section : sections) {
+        if (section.second->empty()) continue;
+        anyChange = true;
+        delta << "\n" << section.first << " (" << section.second->size() << "):\n";
+        for (const auto& line : *section.second) delta << "  " << line << "\n";
+    }
+    if (!anyChange) delta << "\nNo changes.\n";
+    return delta.str();
+}
+
+/*
+ * SaveDeltaReport:
+ * Compares the validated state with an earlier ROOT report and writes
+ * the changes (FormatDelta) to the console and to filename
+ *
+ * Returns:
+ *   false if there was no usable earlier report
+ */
+bool SaveDeltaReport(const TString& filename, const TString& previousReport, const GlobalState& state = gState) {
+    ReportDigest previous;
+    if (previousReport.IsNull()) {
+        std::cout << "No earlier ROOT report found, the next run compares against this one." << std::endl;
+        return false;
+    }
+    if (!LoadReportDigest(previousReport, previous)) return false;
+
+    std::ostringstream delta;
+    delta << "===== DELTA REPORT =====\n";
+    delta << "Ladder: " << state.currentLadder << "\n";
+    delta << "Compared with: " << gSystem->BaseName(previousReport) << "\n";
+    delta << FormatDelta(previous, DigestState(state));
+    std::cout << "\n" << delta.str() << std::flush;
+
+    std::ofstream out(filename.Data());
+    out << delta.str();
+    out.close();
+    if (out.fail()) {
+        std::cerr << "Error: Could not write delta report: " << filename << std::endl;
+    } else {
+        std::cout << "Delta report saved to: " << filename << std::endl;
+    }
+    return true;
+}
+
+// ===================================================================
+// Directory Processing
+// ===================================================================
+/*
+ * ListSubdirectories:
+ * Names of the subfolders of a directory, in listing order. The type comes
+ * from the d_type of the listing (readdir fetches the entries in bulk with
+ * getdents), so only entries whose type is not reported (or symbolic links)
+ * are stat'ed.
+ *
+ * Returns:
+ *   false if the directory could not be read
+ */
+bool ListSubdirectories(const TString& path, std::vector<std::string>& names) {
+    int dirFd = open(path.Data(), O_RDONLY | O_DIRECTORY);
+    DIR* dir = (dirFd >= 0) ? fdopendir(dirFd) : nullptr;
+    CountIo(dir ? 3 : 1);  // open, final readdir, closedir
+    if (!dir) {
+        if (dirFd >= 0) close(dirFd);
+        return false;
+    }
+
+    while (struct dirent* ent = readdir(dir)) {
+        CountIo(1);
+        const char* name = ent->d_name;
+        if (strcmp(name, ".") == 0 || strcmp(name, "..") == 0) continue;
+        bool isDirectory = (ent->d_type == DT_DIR);
+        if (ent->d_type == DT_UNKNOWN || ent->d_type == DT_LNK) {
+            struct stat st;
+            isDirectory = (fstatat(dirFd, name, &st, 0) == 0 && S_ISDIR(st.st_mode));
+            CountIo(1);
+        }
+        if (isDirectory) names.push_back(name);
+    }
+    closedir(dir);
+    return true;
+}
+
+/*
+ * IsSystemFolder:
+ * Hidden folders and common ROOT/system directories, never validated
+ */
+bool IsSystemFolder(const std::string& name) {
+    return name[0] == '.' || name == "root" || name == "sys" || name == "etc";
+}
+
+/*
+ * MatchesAnyGlob:
+ * True if name matches one of the shell patterns (fnmatch)
+ */
+bool MatchesAnyGlob(const std::string& name, const std::vector<std::string>& globs) {
+    for (const auto& glob : globs) {
+        if (fnmatch(glob.c_str(), name.c_str(), 0) == 0) return true;
+    }
+    return false;
+}
+
+/*
+ * HasTestRunStructure:
+ * Cheap test for a folder written by a test run: its <dir>_log.log or one
+ * of the trim_files/pscan_files/conn_check_files subfolders exists.
+ * At most four access() calls, nothing is listed.
+ */
+bool HasTestRunStructure(const TString& ladderDir, const std::string& dirName) {
+    std::string dirPath = std::string(ladderDir.Data()) + "/" + dirName + "/";
+    std::string marks[4] = {dirName + "_log.log", kTrimRules.folder, kPscanRules.folder, kConnRules.folder};
+    for (const auto& mark : marks) {
+        CountIo(1);
+        if (access((dirPath + mark).c_str(), F_OK) == 0) return true;
+    }
+    return false;
+}
+
+/*
+ * FindValidationDirectories:
+ * Scans a ladder folder (the current working directory by default) to identify
+ * all potential validation directories.
+ *
+ * Parameters:
+ *   ladderDir - Folder to scan
+ *   verbose   - Print the number of directories found (and skipped)
+ * 
+ * Returns:
+ *   std::vector<TString> - List of directory names that should be validated
+ *
+ * Directory Selection Criteria:
+ * - Must be a directory (not a file), not hidden (names starting with '.')
+ *   and not a known system directory
+ * - Must match --include (if given) and must not match --exclude
+ * - Must have a test-run structure (see HasTestRunStructure), unless
+ *   --discover=all: report folders, scratch folders and backups are
+ *   never sent through the validators
+ */
+std::vector<TString> FindValidationDirectories(const TString& ladderDir = gSystem->pwd(), bool verbose = true) {
+    ScopedStage stage(STAGE_DISCOVERY);
+    std::vector<TString> directories;  // Stores found directories
+
+    std::vector<std::string> names;
+    if (!ListSubdirectories(ladderDir, names)) {
+        std::cerr << "Error: Could not read directory contents from: " << ladderDir << std::endl;
+        return directories;  // Return empty vector on error
+    }
+
+    int excluded = 0;      // Filtered out by --include/--exclude
+    int unstructured = 0;  // No test-run structure
+    for (const auto& name : names) {
+        if (IsSystemFolder(name)) continue;
+        if ((!gOptions.includeGlobs.empty() && !MatchesAnyGlob(name, gOptions.includeGlobs)) ||
+            MatchesAnyGlob(name, gOptions.excludeGlobs)) {
+            excluded++;
+            continue;
+        }
+        if (!gOptions.discoverAll && !HasTestRunStructure(ladderDir, name)) {
+            unstructured++;
+            continue;
+        }
+        directories.push_back(name.c_str());
+    }
+
+    // Log findings to console
+    if (verbose) {
+        std::cout << "Found " << directories.size() 
+                  << " potential validation directories." << std::endl;
+        if (excluded > 0) {
+            std::cout << "Skipped " << excluded << " folders excluded by --include/--exclude." << std::endl;
+        }
+        if (unstructured > 0) {
+            std::cout << "Skipped " << unstructured << " folders without a log file or check subfolders"
+                      << " (--discover=all validates them)." << std::endl;
+        }
+    }
+    
+    return directories;
+}
+
+/*
+ * CapturedCheck Structure:
+ * Result of one validator run on a worker thread, with its console output
+ */
+struct CapturedCheck {
+    ValidationResult result;  // Validator findings
+    std::string out;          // Captured Out() text
+    std::string err;          // Captured Err() text
+};
+
+typedef ValidationResult (*CheckFunction)(const char*, const TString&);
+
+/*
+ * RunCapturedCheck:
+ * Runs a validator with its console output redirected to buffers
+ */
+CapturedCheck RunCapturedCheck(CheckFunction check, const TString& dirName, const TString& currentDir) {
+    std::ostringstream out, err;
+    tOutBuffer = &out;
+    tErrBuffer = &err;
+
+    CapturedCheck captured;
+    captured.result = check(dirName.Data(), currentDir);
+
+    tOutBuffer = nullptr;
+    tErrBuffer = nullptr;
+    captured.out = out.str();
+    captured.err = err.str();
+    return captured;
+}
+
+const CheckFunction kChecks[4] = {CheckLogFiles, CheckTrimFiles, CheckPscanFiles, CheckConnFiles};
+const int kCheckBits[4] = {CHECK_LOG, CHECK_TRIM, CHECK_PSCAN, CHECK_CONN};
+
+/*
+ * EchoDirectory:
+ * Writes the console output of one validated directory in a single pass,
+ * after all of its checks finished: the captured validator text in validator
+ * order, or one status line with --verbosity=quiet
+ */
+void EchoDirectory(const DirectoryValidation& validation, const CapturedCheck (&captured)[4]) {
+    if (gOptions.verbosity == VERBOSITY_QUIET) {
+        std::string statusStr;
+        int dirStatus = EvaluateDirectoryStatus(validation, statusStr);
+        std::cout << validation.dirName << ": " << kStatusNames[dirStatus] << '\n';
+        return;
+    }
+    for (int c = 0; c < 4; c++) {
+        if (!captured[c].err.empty()) std::cerr << captured[c].err;
+        if (!captured[c].out.empty()) std::cout << captured[c].out;
+    }
+    std::cout << std::flush;
+}
+
+/*
+ * PendingValidations Structure:
+ * Validations of one ladder whose checks have been queued on a pool
+ */
+struct PendingValidations {
+    std::vector<DirectoryValidation> validations;                    // Results, filled on merge
+    std::vector<std::array<std::future<CapturedCheck>, 4>> checks;   // Queued checks per directory
+};
+
+/*
+ * SubmitValidations:
+ * Queues the validators selected in checkMasks[i] for validations[i]
+ * as independent pool tasks and returns without waiting
+ */
+PendingValidations SubmitValidations(ThreadPool& pool, std::vector<DirectoryValidation> validations,
+                                     const std::vector<int>& checkMasks, const TString& currentDir) {
+    PendingValidations pending;
+    pending.checks.resize(validations.size());
+    for (size_t i = 0; i < validations.size(); i++) {
+        TString dir = validations[i].dirName;
+        for (int c = 0; c < 4; c++) {
+            if (!(checkMasks[i] & kCheckBits[c])) continue;
+            CheckFunction check = kChecks[c];
+            pending.checks[i][c] = pool.Submit([check, dir, currentDir]() {
+                return RunCapturedCheck(check, dir, currentDir);
+            });
+        }
+    }
+    pending.validations = std::move(validations);
+    return pending;
+}
+
+/*
+ * MergeValidations:
+ * Waits for the queued checks in directory order and records each
+ * directory into state. Captured console output is replayed through
+ * EchoDirectory when echoOutput is set and dropped otherwise.
+ */
+void MergeValidations(PendingValidations& pending, GlobalState& state, bool echoOutput) {
+    for (size_t i = 0; i < pending.validations.size(); i++) {
+        DirectoryValidation& validation = pending.validations[i];
+        ValidationResult* targets[4] = {&validation.logResult, &validation.trimResult,
+                                        &validation.pscanResult, &validation.connResult};
+        CapturedCheck captured[4];
+        for (int c = 0; c < 4; c++) {
+            if (!pending.checks[i][c].valid()) continue;
+            captured[c] = pending.checks[i][c].get();
+            *targets[c] = std::move(captured[c].result);
+        }
+        if (echoOutput) EchoDirectory(validation, captured);
+        RecordDirectoryValidation(std::move(validation), state);
+    }
+}
+
+/*
+ * RunValidations:
+ * Runs the validators selected in checkMasks[i] for validations[i], keeps
+ * the other results as they are, and merges everything into gState.
+ *
+ * Operation:
+ * - With one worker, checks run sequentially on the calling thread
+ * - With more workers, every selected (directory, validator) pair becomes
+ *   an independent pool task, so directories and their four subfolder
+ *   checks run at the same time
+ * - Results and captured console output are consumed in directory order,
+ *   keeping gState and all reports deterministic
+ * - Validator output is buffered per check and written once per directory
+ *   (EchoDirectory); only --verbosity=verbose prints a sequential run as it
+ *   happens, for tracing
+ * - In verdict-only mode validator output is dropped, and a sequential run
+ *   skips the other validators of a directory once it has a directory error
+ */
+void RunValidations(std::vector<DirectoryValidation> validations, const std::vector<int>& checkMasks) {
+    TString currentDir = gSystem->pwd();
+    bool echoOutput = !gOptions.verdictOnly;
+    bool directOutput = echoOutput && gOptions.verbosity >= VERBOSITY_VERBOSE;
+
+    int nWorkers = ResolveWorkerCount(gOptions.workers);
+    if (nWorkers <= 1 || validations.size() <= 1) {
+        for (size_t i = 0; i < validations.size(); i++) {
+            ValidationResult* targets[4] = {&validations[i].logResult, &validations[i].trimResult,
+                                            &validations[i].pscanResult, &validations[i].connResult};
+            CapturedCheck captured[4];
+            for (int c = 0; c < 4; c++) {
+                if (!(checkMasks[i] & kCheckBits[c])) continue;
+                if (directOutput) {
+                    *targets[c] = kChecks[c](validations[i].dirName.Data(), currentDir);
+                } else {
+                    captured[c] = RunCapturedCheck(kChecks[c], validations[i].dirName, currentDir);
+                    *targets[c] = std::move(captured[c].result);
+                }
+                // A directory error is the worst status, the other validators can't change it
+                if (gOptions.verdictOnly && CheckStatus(kCheckBits[c], targets[c]->flags) == STATUS_DIRECTORY_ERROR) break;
+            }
+            if (echoOutput && !directOutput) EchoDirectory(validations[i], captured);
+            RecordDirectoryValidation(std::move(validations[i]));
+        }
+        return;
+    }
+
+    std::cout << "Validating with " << nWorkers << " worker threads" << std::endl;
+    ROOT::EnableThreadSafety();  // TFile::Open may be called from several threads
+
+    ThreadPool pool(nWorkers);
+
+    // Queue all selected checks up front, then merge in fixed order
+    // while later directories are still running
+    PendingValidations pending = SubmitValidations(pool, std::move(validations), checkMasks, currentDir);
+    MergeValidations(pending, gState, echoOutput);
+}
+
+/*
+ * ValidateDirectories:
+ * Runs all four validators for every directory and merges the
+ * results into gState (in the given order). With --resume, directories
+ * checkpointed unchanged in gState.journal are taken from it.
+ */
+void ValidateDirectories(const std::vector<TString>& directories) {
+    std::vector<DirectoryValidation> validations(directories.size());
+    for (size_t i = 0; i < directories.size(); i++) {
+        validations[i].dirName = directories[i];
+    }
+    std::vector<int> checkMasks(directories.size(), CHECK_ALL);
+    if (gState.journal) gState.journal->Resume(validations, checkMasks);
+    RunValidations(std::move(validations), checkMasks);
+}
+
+/*
+ * RevalidateChangedDirectories:
+ * Post-cleanup pass. Only validators whose folder had files deleted are
+ * run again; results of untouched directories and subfolders are carried
+ * over from the previous pass.
+ *
+ * Parameters:
+ *   previous - Results of the previous pass, in directory order (consumed)
+ *   touched  - Directory name -> CHECK_* mask of folders changed by cleanup
+ */
+void RevalidateChangedDirectories(std::vector<DirectoryValidation> previous,
+                                  const std::map<TString, int>& touched) {
+    std::vector<int> checkMasks(previous.size(), 0);
+    int changedDirs = 0;
+    for (size_t i = 0; i < previous.size(); i++) {
+        auto it = touched.find(previous[i].dirName);
+        if (it != touched.end()) {
+            checkMasks[i] = it->second;
+            changedDirs++;
+        }
+    }
+
+    std::cout << "Re-validating " << changedDirs << " of " << previous.size()
+              << " directories changed by cleanup" << std::endl;
+    RunValidations(std::move(previous), checkMasks);
+}
+
+// ===================================================================
+// File Cleanup Function
+// ===================================================================
+/*
+ * CleanupAction Structure:
+ * One proposed deletion of the cleanup plan
+ */
+struct CleanupAction {
+    TString dir;                // Test directory (relative to the ladder folder)
+    TString subdir;             // Folder inside it ("" = the test directory itself)
+    std::string file;           // File name
+    std::string type;           // invalid-data, tester, empty, unexpected, module-error, wrong-format
+    std::string reason;         // Why the file is proposed for deletion
+    std::string matchedTester;  // Invalid data files: tester file paired with it
+    FileEntry planned;          // Manifest: size, mtime and inode when the plan was written
+};
+
+/*
+ * CleanupGroup Structure:
+ * Deletions confirmed together (one prompt in interactive mode)
+ */
+struct CleanupGroup {
+    int kind;                            // CLEANUP_GROUP_* value
+    std::string title;                   // Category name, or folder of wrong-format files
+    bool onlyEmptyFiles = false;         // Subject to --cleanup-policy=auto-empty
+    std::vector<CleanupAction> actions;  // Files of the group
+};
+
+/*
+ * CleanupOutcome Structure:
+ * Result of executing cleanup actions
+ */
+struct CleanupOutcome {
+    std::vector<std::string> deletedFiles;     // Successfully deleted files
+    std::vector<std::string> failedDeletions;  // Files that couldn't be deleted
+    std::vector<std::string> changedFiles;     // Manifest entries changed since the plan (kept)
+    std::map<TString, int> touchedFolders;     // Folders changed by deletions
+};
+
+/*
+ * CheckMaskForFolder:
+ * Validator reading a folder of a test directory
+ */
+int CheckMaskForFolder(const TString& subdir) {
+    if (subdir == "trim_files") return CHECK_TRIM;
+    if (subdir == "pscan_files") return CHECK_PSCAN;
+    if (subdir == "conn_check_files") return CHECK_CONN;
+    return CHECK_LOG;
+}
+
+/*
+ * BuildCleanupPlan:
+ * Collects every proposed deletion from the validation results, grouped
+ * the way they are confirmed: one group per invalid data-tester pair,
+ * per problem-file category and per folder with wrong-format files.
+ * Log files are never proposed.
+ */
+std::vector<CleanupGroup> BuildCleanupPlan(const std::vector<DirectoryValidation>& results) {
+    std::vector<CleanupGroup> plan;
+
+    for (const auto& validation : results) {
+        const TString& dir = validation.dirName;
+
+        // Reuse the error lists from the validation pass
+        const ValidationResult& logResult = validation.logResult;
+        const ValidationResult& trimResult = validation.trimResult;
+        const ValidationResult& pscanResult = validation.pscanResult;
+        const ValidationResult& connResult = validation.connResult;
+
+        // ===============================================================
+        // 1. DATA-TESTER PAIRS
+        // ===============================================================
+        /* Pairs were already matched by CheckLogFiles during validation */
+        std::unordered_map<std::string_view, size_t> pairIndex;
+        for (size_t i = 0; i < logResult.dataTesterPairs.size(); i++) {
+            pairIndex.emplace(logResult.dataTesterPairs[i].first, i);
+        }
+
+        for (const auto& invalidFile : logResult.invalidFiles) {
+            // Skip log files from deletion
+            if (HasSuffix(invalidFile, ".log")) {
+                continue;
+            }
+
+            auto pairIt = pairIndex.find(invalidFile);
+            if (pairIt == pairIndex.end()) continue;
+            const auto& pair = logResult.dataTesterPairs[pairIt->second];
+
+            CleanupGroup group;
+            group.kind = CLEANUP_GROUP_PAIR;
+            group.title = "Invalid data-tester pair";
+            group.actions.push_back({dir, "", pair.first, "invalid-data",
+                                     "Invalid content in data file", pair.second, {}});
+            if (!pair.second.empty()) {
+                group.actions.push_back({dir, "", pair.second, "tester",
+                                         "Matched with invalid data file " + pair.first, "", {}});
+            }
+            plan.push_back(group);
+        }
+
+        // ===============================================================
+        // 2. OTHER PROBLEMATIC FILES
+        // ===============================================================
+        struct FileCategory {
+            std::string name;
+            const NameList* files;
+            TString subdir;
+            std::string type;   // Manifest type of the files
+            bool emptyFiles;    // Category holds empty files only
+        };
+
+        // Define cleanup categories
+        const FileCategory categories[] = {
+            {"Empty log data files", &logResult.emptyFiles, "", "empty", true},
+            {"Unexpected files in log directory", &logResult.unexpectedFiles, "", "unexpected", false},
+            {"Empty pscan files", &pscanResult.emptyFiles, "pscan_files", "empty", true},
+            {"Module test file errors", &pscanResult.moduleErrorFiles, "pscan_files", "module-error", false},
+            {"Unexpected files in pscan directory", &pscanResult.unexpectedFiles, "pscan_files", "unexpected", false}
+        };
+
+        for (const auto& category : categories) {
+            CleanupGroup group;
+            group.kind = CLEANUP_GROUP_CATEGORY;
+            group.title = category.name;
+            group.onlyEmptyFiles = category.emptyFiles;
+            for (const auto& file : *category.files) {
+                // Filter out log files from all categories
+                if (HasSuffix(file, ".log")) continue;
+                group.actions.push_back({dir, category.subdir, std::string(file), category.type, category.name, "", {}});
+            }
+            if (!group.actions.empty()) plan.push_back(group);
+        }
+
+        // ===============================================================
+        // 3. SPECIAL HANDLING FOR TRIM AND CONN FILES
+        // ===============================================================
+        /* Only files with a wrong name format are proposed */
+        auto addWrongFormatFiles = [&](const NameList& files, const FolderRules& folder) {
+            TString subdir = folder.folder;
+            CleanupGroup group;
+            group.kind = CLEANUP_GROUP_FORMAT;
+            group.title = subdir.Data();
+            for (const auto& file : files) {
+                // Skip log files
+                if (HasSuffix(file, ".log")) {
+                    continue;
+                }
+
+                // Check file name format
+                bool validFormat = ClassifyFile(folder, file) >= 0;
+                if (!validFormat) {
+                    group.actions.push_back({dir, subdir, std::string(file), "wrong-format",
+                                             "Wrong file name format in " + std::string(subdir.Data()), "", {}});
+                }
+            }
+            if (!group.actions.empty()) plan.push_back(group);
+        };
+
+        addWrongFormatFiles(trimResult.unexpectedFiles, kTrimRules);
+        addWrongFormatFiles(connResult.unexpectedFiles, kConnRules);
+    }
+    return plan;
+}
+
+/*
+ * CleanupActionFolder:
+ * Folder of an action's file, relative to the ladder folder
+ */
+TString CleanupActionFolder(const CleanupAction& action) {
+    return action.subdir.IsNull() ? action.dir : action.dir + "/" + action.subdir;
+}
+
+/*
+ * ExecuteCleanupAction:
+ * Deletes the file of one action, or moves it into quarantineDir when
+ * that is set. Runs on the deletion workers.
+ *
+ * Returns:
+ *   true if the file was removed from its folder
+ */
+bool ExecuteCleanupAction(const CleanupAction& action, const TString& currentDir,
+                          const std::string& quarantineDir) {
+    ScopedStage stage(STAGE_CLEANUP);  // Runs on the deletion workers
+    CountFile();
+    TString relativeDir = CleanupActionFolder(action);
+    TString folderPath = currentDir + "/" + relativeDir;
+
+    if (quarantineDir.empty()) {
+        return RemoveFile(folderPath, action.file);
+    }
+    return QuarantineFile(folderPath, action.file, quarantineDir, relativeDir.Data());
+}
+
+/*
+ * RecordCleanupResult:
+ * Adds the result of one executed action to the outcome
+ */
+void RecordCleanupResult(const CleanupAction& action, bool removed, CleanupOutcome& outcome) {
+    if (removed) {
+        outcome.touchedFolders[action.dir] |= CheckMaskForFolder(action.subdir);
+        outcome.deletedFiles.push_back(action.file);
+    } else {
+        outcome.failedDeletions.push_back(action.file);
+    }
+}
+
+/*
+ * DeletionQueue:
+ * Runs cleanup actions on a small pool so that slow (network filesystem)
+ * unlinks overlap, and hands the results back in submission order
+ */
+class DeletionQueue {
+public:
+    DeletionQueue(const TString& currentDir, const std::string& quarantineDir)
+        : pool(ResolveWorkerCount(gOptions.deleteWorkers)),
+          currentDir(currentDir), quarantineDir(quarantineDir) {
+        if (ResolveWorkerCount(gOptions.deleteWorkers) > 1) {
+            ROOT::EnableThreadSafety();  // gSystem->Unlink from several threads
+        }
+    }
+
+    // The action must stay alive until its result has been taken
+    std::future<bool> Submit(const CleanupAction& action) {
+        const CleanupAction* queued = &action;
+        TString dir = currentDir;
+        std::string quarantine = quarantineDir;
+        return pool.Submit([queued, dir, quarantine]() {
+            return ExecuteCleanupAction(*queued, dir, quarantine);
+        });
+    }
+
+private:
+    ThreadPool pool;
+    TString currentDir;
+    std::string quarantineDir;
+};
+
+/*
+ * ConfirmCleanupGroup:
+ * Shows one group as in the interactive cleanup and decides whether
+ * it is deleted: automatically by --cleanup-policy, otherwise by asking
+ */
+bool ConfirmCleanupGroup(const CleanupGroup& group) {
+    const size_t nFiles = group.actions.size();
+    if (group.kind == CLEANUP_GROUP_PAIR) {
+        const CleanupAction& data = group.actions.front();
+        std::cout << "\n===== INVALID DATA-TESTER PAIR =====" << std::endl;
+        std::cout << "Data file: " << data.file << std::endl;
+        if (!data.matchedTester.empty()) {
+            std::cout << "Matched tester file: " << data.matchedTester << std::endl;
+        } else {
+            std::cout << "No matching tester file found" << std::endl;
+        }
+    } else if (group.kind == CLEANUP_GROUP_CATEGORY) {
+        std::cout << "\n===== " << group.title << " =====" << std::endl;
+        std::cout << "Found " << nFiles << " files:" << std::endl;
+    } else {
+        std::cout << "\n===== INVALID FORMAT FILES IN " << group.title << " =====" << std::endl;
+        std::cout << "Found " << nFiles << " files with wrong format:" << std::endl;
+    }
+    if (group.kind != CLEANUP_GROUP_PAIR) {
+        for (const auto& action : group.actions) {
+            std::cout << " - " << action.file << std::endl;
+        }
+    }
+
+    bool automatic = (gOptions.cleanupPolicy == POLICY_AUTO_ALL) ||
+                     (gOptions.cleanupPolicy == POLICY_AUTO_EMPTY && group.onlyEmptyFiles);
+    if (automatic) {
+        std::cout << "Deleting automatically (cleanup policy)" << std::endl;
+        return true;
+    }
+
+    // Interactive confirmation
+    if (group.kind == CLEANUP_GROUP_PAIR) {
+        std::cout << "Delete this file pair? (y/n): ";
+    } else if (group.kind == CLEANUP_GROUP_CATEGORY) {
+        std::cout << "\nDelete these " << nFiles << " files? (y/n): ";
+    } else {
+        std::cout << "\nDelete these " << nFiles << " invalid format files? (y/n): ";
+    }
+    std::string response;
+    {
+        ScopedStage stage(STAGE_PROMPT);
+        std::getline(std::cin, response);
+    }
+    return response == "y" || response == "Y";
+}
+
+/*
+ * RunInteractiveCleanup:
+ * Asks for every group of the plan (subject to the policy). Confirmed
+ * groups are queued for deletion at once, so deletions proceed while
+ * the next question is answered; results are reported at the end.
+ */
+void RunInteractiveCleanup(const std::vector<CleanupGroup>& plan, DeletionQueue& queue,
+                           CleanupOutcome& outcome) {
+    std::vector<const CleanupGroup*> confirmed;
+    std::vector<std::vector<std::future<bool>>> results;
+    for (const auto& group : plan) {
+        if (!ConfirmCleanupGroup(group)) continue;
+
+        confirmed.push_back(&group);
+        results.emplace_back();
+        for (const auto& action : group.actions) {
+            results.back().push_back(queue.Submit(action));
+        }
+    }
+
+    if (!confirmed.empty()) {
+        std::cout << "\n===== DELETING CONFIRMED FILES =====" << std::endl;
+    }
+    for (size_t g = 0; g < confirmed.size(); g++) {
+        const CleanupGroup& group = *confirmed[g];
+        for (size_t i = 0; i < group.actions.size(); i++) {
+            const CleanupAction& action = group.actions[i];
+            bool removed = results[g][i].get();
+            RecordCleanupResult(action, removed, outcome);
+
+            if (group.kind == CLEANUP_GROUP_PAIR) {
+                const char* role = (i == 0) ? "data" : "tester";
+                if (removed) {
+                    std::cout << "Deleted " << role << " file: " << action.file << std::endl;
+                } else {
+                    std::cout << "Failed to delete " << role << " file: " << action.file << std::endl;
+                }
+            }
+        }
+        if (group.kind != CLEANUP_GROUP_PAIR) {
+            std::cout << "Deleted " << group.actions.size() << " files." << std::endl;
+        }
+    }
+}
+
+/*
+ * WriteCleanupManifest:
+ * Writes the whole plan as a tab-separated manifest, one deletion per line,
+ * for review and a later --cleanup=apply run. Every line records the
+ * file's size, modification time and inode, so apply can tell whether it
+ * is still the file that was planned for deletion.
+ *
+ * Returns:
+ *   Number of actions written, -1 if the file could not be created
+ */
+int WriteCleanupManifest(const std::vector<CleanupGroup>& plan, const std::string& path,
+                         const TString& currentDir) {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        std::cerr << "Error: Could not open cleanup manifest for writing: " << path << std::endl;
+        return -1;
+    }
+
+    out << CLEANUP_MANIFEST_HEADER << "\n";
+    out << "# Ladder: " << gState.currentLadder << "\n";
+    out << "# Remove lines (or change the action to keep) to spare files, then run with --cleanup=apply\n";
+    out << "# action\ttype\tdirectory\tfolder\tfile\treason\tmatched_tester\tsize\tmtime_ns\tinode\n";
+
+    int written = 0;
+    for (const auto& group : plan) {
+        for (const auto& action : group.actions) {
+            if (action.file.find_first_of("\t\n") != std::string::npos) {
+                std::cerr << "Warning: File name cannot be stored in the manifest, skipped: "
+                          << action.file << std::endl;
+                continue;
+            }
+            FileEntry entry;
+            StatEntry(std::string((currentDir + "/" + CleanupActionFolder(action)).Data()) + "/" + action.file, entry);
+            out << "delete\t" << action.type << "\t" << action.dir << "\t"
+                << (action.subdir.IsNull() ? "." : action.subdir.Data()) << "\t"
+                << action.file << "\t" << action.reason << "\t" << action.matchedTester << "\t"
+                << entry.size << "\t" << entry.mtime << "\t" << entry.inode << "\n";
+            written++;
+        }
+    }
+    return written;
+}
+
+/*
+ * ReadCleanupManifest:
+ * Reads the deletions of a (possibly edited) manifest. Lines whose action
+ * is not "delete" are skipped; entries that would leave the ladder folder,
+ * list a log file or have a type BuildCleanupPlan never writes are rejected.
+ *
+ * Returns:
+ *   false if the manifest cannot be read, has an unknown format or was
+ *   written for another ladder
+ */
+bool ReadCleanupManifest(const std::string& path, std::vector<CleanupAction>& actions) {
+    std::ifstream in(path);
+    if (!in.is_open()) {
+        std::cerr << "Error: Cannot open cleanup manifest: " << path << std::endl;
+        return false;
+    }
+
+    std::string line;
+    if (!std::getline(in, line) || line != CLEANUP_MANIFEST_HEADER) {
+        std::cerr << "Error: Not a cleanup manifest of this version (write a new one with --cleanup=plan): "
+                  << path << std::endl;
+        return false;
+    }
+    std::string ladderLine = "# Ladder: " + gState.currentLadder;
+    if (!std::getline(in, line) || line != ladderLine) {
+        std::cerr << "Error: Cleanup manifest was not written for ladder " << gState.currentLadder
+                  << ", nothing is deleted: " << path << std::endl;
+        return false;
+    }
+
+    int lineNumber = 2;
+    while (std::getline(in, line)) {
+        lineNumber++;
+        if (line.empty() || line[0] == '#') continue;
+
+        std::vector<std::string> fields;
+        std::istringstream stream(line);
+        std::string field;
+        while (std::getline(stream, field, '\t')) {
+            fields.push_back(field);
+        }
+        if (fields.size() < 10) {
+            std::cerr << "Warning: Malformed manifest line " << lineNumber << " ignored" << std::endl;
+            continue;
+        }
+        if (fields[0] != "delete") continue;
+
+        const std::string& dir = fields[2];
+        const std::string& folder = fields[3];
+        const std::string& file = fields[4];
+        bool unsafe = dir.empty() || file.empty() || file.find('/') != std::string::npos ||
+                      dir.find('/') != std::string::npos || folder.find('/') != std::string::npos ||
+                      dir == ".." || file == ".." || folder == ".." || dir == "." || file == ".";
+        if (unsafe) {
+            std::cerr << "Warning: Manifest line " << lineNumber
+                      << " points outside the ladder folder, ignored" << std::endl;
+            continue;
+        }
+        /* Same rules as BuildCleanupPlan, whatever was edited into the manifest */
+        if (HasSuffix(file, ".log")) {
+            std::cerr << "Warning: Manifest line " << lineNumber << " lists a log file, ignored" << std::endl;
+            continue;
+        }
+        static const std::set<std::string> kPlannedTypes = {"invalid-data", "tester", "empty", "unexpected",
+                                                            "module-error", "wrong-format"};
+        if (kPlannedTypes.count(fields[1]) == 0) {
+            std::cerr << "Warning: Manifest line " << lineNumber << " has unknown type \"" << fields[1]
+                      << "\", ignored" << std::endl;
+            continue;
+        }
+
+        CleanupAction action;
+        action.type = fields[1];
+        action.dir = dir.c_str();
+        action.subdir = (folder == ".") ? "" : folder.c_str();
+        action.file = file;
+        action.reason = fields[5];
+        action.matchedTester = fields[6];
+        action.planned.size = atoll(fields[7].c_str());
+        action.planned.mtime = atoll(fields[8].c_str());
+        action.planned.inode = strtoul(fields[9].c_str(), nullptr, 10);
+        actions.push_back(action);
+    }
+    return true;
+}
+
+/*
+ * CleanupManifestPath:
+ * --manifest, or ExorcismCleanup_<ladder>.tsv in the ladder folder
+ */
+std::string CleanupManifestPath() {
+    if (!gOptions.manifestFile.empty()) return gOptions.manifestFile;
+    return std::string(gSystem->WorkingDirectory()) + "/ExorcismCleanup_" + gState.currentLadder + ".tsv";
+}
+
+/*
+ * Extra_Omnes:
+ * Performs the cleanup of problematic files identified during validation.
+ * Latin for "all others out", this function handles all remaining file issues.
+ *
+ * Parameters:
+ *   results - Per-directory results of the validation pass (gState.results);
+ *             nothing is re-validated here
+ *
+ * Returns:
+ *   Directory name -> CHECK_* mask of the folders in which files were deleted
+ *
+ * Modes (--cleanup):
+ * - interactive: one confirmation per group of files [default];
+ *   --cleanup-policy can delete empty files (auto-empty) or everything
+ *   (auto-all) without asking
+ * - plan:  writes every proposed deletion to the manifest, deletes nothing
+ * - apply: deletes everything listed in the (edited) manifest in one go
+ *
+ * Safety Features:
+ * - Log files are never deleted
+ * - Preserves original files if deletion fails
+ * - Comprehensive logging of all actions
+ */
+std::map<TString, int> Extra_Omnes(const std::vector<DirectoryValidation>& results) {
+    ScopedStage stage(STAGE_CLEANUP);
+    std::cout << "\n===== FILE CLEANUP PROCEDURE =====" << std::endl;
+
+    TString currentDir = gSystem->pwd();
+    CleanupOutcome outcome;
+
+    /* Per-run quarantine folder (hidden, so it is never validated) */
+    std::string quarantineDir;
+    if (gOptions.quarantine) {
+        quarantineDir = std::string(currentDir.Data()) + "/" + QUARANTINE_PREFIX +
+                        FormatCurrentTime("%Y%m%d_%H%M%S");
+    }
+
+    if (gOptions.cleanupMode == CLEANUP_PLAN) {
+        std::vector<CleanupGroup> plan = BuildCleanupPlan(results);
+        std::string manifest = CleanupManifestPath();
+        int written = WriteCleanupManifest(plan, manifest, currentDir);
+        if (written >= 0) {
+            std::cout << "Cleanup plan with " << written << " proposed deletions written to: "
+                      << manifest << std::endl;
+            std::cout << "Nothing was deleted. Review the file, then run with --cleanup=apply" << std::endl;
+        }
+        return outcome.touchedFolders;
+    }
+
+    if (gOptions.cleanupMode == CLEANUP_APPLY) {
+        std::string manifest = CleanupManifestPath();
+        std::vector<CleanupAction> actions;
+        if (!ReadCleanupManifest(manifest, actions)) {
+            return outcome.touchedFolders;
+        }
+        std::cout << "Applying " << actions.size() << " deletions from: " << manifest << std::endl;
+
+        // Only files that are still the ones planned for deletion
+        std::vector<CleanupAction> unchanged;
+        for (auto& action : actions) {
+            std::string filePath = std::string((currentDir + "/" + CleanupActionFolder(action)).Data()) + "/" + action.file;
+            FileEntry entry;
+            StatEntry(filePath, entry);
+            if (entry.statOk && entry.size == action.planned.size && entry.mtime == action.planned.mtime &&
+                entry.inode == action.planned.inode) {
+                unchanged.push_back(std::move(action));
+            } else {
+                std::cerr << "Warning: " << (entry.statOk ? "Changed" : "Missing")
+                          << " since the plan, not deleted: " << filePath << std::endl;
+                outcome.changedFiles.push_back(action.file);
+            }
+        }
+        actions = std::move(unchanged);
+
+        DeletionQueue queue(currentDir, quarantineDir);
+        std::vector<std::future<bool>> removed;
+        removed.reserve(actions.size());
+        for (const auto& action : actions) {
+            removed.push_back(queue.Submit(action));
+        }
+        for (size_t i = 0; i < actions.size(); i++) {
+            RecordCleanupResult(actions[i], removed[i].get(), outcome);
+        }
+    } else {
+        std::cout << "This will remove problematic files after confirmation." << std::endl;
+        std::vector<CleanupGroup> plan = BuildCleanupPlan(results);
+        DeletionQueue queue(currentDir, quarantineDir);
+        RunInteractiveCleanup(plan, queue, outcome);
+    }
+    
+    // ===================================================================
+    // GENERATE CLEANUP REPORT
+    // ===================================================================
+    std::stringstream cleanupReport;
+    cleanupReport << "\n===== FILE CLEANUP REPORT =====" << std::endl;
+    cleanupReport << "Total deleted files: " << outcome.deletedFiles.size() << std::endl;
+    cleanupReport << "Total failed deletions: " << outcome.failedDeletions.size() << std::endl;
+    if (!quarantineDir.empty() && !outcome.deletedFiles.empty()) {
+        cleanupReport << "Deleted files were moved to: " << quarantineDir
+                      << " (move them back to restore)" << std::endl;
+    }
+    
+    if (!outcome.deletedFiles.empty()) {
+        cleanupReport << "\nSuccessfully deleted files:" << std::endl;
+        for (const auto& file : outcome.deletedFiles) {
+            cleanupReport << " - " << file << std::endl;
+        }
+    }
+    
+    if (!outcome.failedDeletions.empty()) {
+        cleanupReport << "\nFailed to delete:" << std::endl;
+        for (const auto& file : outcome.failedDeletions) {
+            cleanupReport << " - " << file << std::endl;
+        }
+    }
+
+    if (!outcome.changedFiles.empty()) {
+        cleanupReport << "\nKept (changed or missing since the plan):" << std::endl;
+        for (const auto& file : outcome.changedFiles) {
+            cleanupReport << " - " << file << std::endl;
+        }
+    }
+    
+    // Add to global report
+    gState.globalSummary += cleanupReport.str();
+    
+    std::cout << cleanupReport.str() << std::endl;
+    return outcome.touchedFolders;
+}
+
+/*
+ * StartQuarantinePurge:
+ * Deletes the quarantine folders left in ladderDir by earlier runs on a
+ * background thread. The folders are listed before it starts, so a
+ * quarantine folder created later by this run is never touched.
+ *
+ * Returns:
+ *   Future holding the number of folders removed completely
+ */
+std::future<int> StartQuarantinePurge(const TString& ladderDir) {
+    std::vector<std::string> folders;
+    DirectorySnapshot listing = ScanDirectory(ladderDir.Data());
+    for (const auto& entry : listing.entries) {
+        if (entry.isDirectory && TString(entry.name.c_str()).BeginsWith(QUARANTINE_PREFIX)) {
+            folders.push_back(std::string(ladderDir.Data()) + "/" + entry.name);
+        }
+    }
+
+    return std::async(std::launch::async, [folders]() {
+        int purged = 0;
+        for (const auto& folder : folders) {
+            if (RemoveTree(folder)) {
+                purged++;
+            } else {
+                std::cerr << "Warning: Could not completely remove quarantine folder: " << folder << std::endl;
+            }
+        }
+        return purged;
+    });
+}
+
+// ===================================================================
+// Option Parsing
+// ===================================================================
+/*
+ * ParseFormats:
+ * Converts a comma-separated format list ("txt,json") into a FORMAT_* mask.
+ * Unknown entries are reported and skipped.
+ */
+int ParseFormats(const std::string& list) {
+    int formats = 0;
+    std::istringstream stream(list);
+    std::string format;
+    while (std::getline(stream, format, ',')) {
+        if (format == "txt") {
+            formats |= FORMAT_TXT;
+        } else if (format == "root") {
+            formats |= FORMAT_ROOT;
+        } else if (format == "pdf") {
+            formats |= FORMAT_PDF;
+        } else if (format == "json") {
+            formats |= FORMAT_JSON;
+        } else if (format == "csv") {
+            formats |= FORMAT_CSV;
+        } else if (!format.empty()) {
+            std::cerr << "Warning: Unknown report format ignored: " << format << std::endl;
+        }
+    }
+    return formats;
+}
+
+/*
+ * ParseCount:
+ * Reads a whole decimal option value into 0..maxValue.
+ * Returns false (count unchanged) for anything else, e.g. "eight" or "2s".
+ */
+bool ParseCount(const std::string& value, int& count, long maxValue = INT_MAX) {
+    if (value.empty() || !isdigit(static_cast<unsigned char>(value[0]))) return false;
+    errno = 0;
+    char* end = nullptr;
+    long parsed = strtol(value.c_str(), &end, 10);
+    if (errno != 0 || *end != '\0' || parsed > maxValue) return false;
+    count = static_cast<int>(parsed);
+    return true;
+}
+
+/*
+ * ParseOptions:
+ * Reads space-separated options of the form "--name=value" into gOptions.
+ *
+ * Supported options:
+ *   --workers=N   Number of validation worker threads
+ *                 (1 = sequential [default], 0 = one per CPU core)
+ *   --root-check=fast|deep  Validate ROOT files by their header [default]
+ *                 or by fully opening them with TFile::Open
+ *   --no-cache    Do not read or write the validation cache
+ *   --cache-file=PATH  Validation cache location (default <ladder>/.exorcism_cache)
+ *   --formats=LIST  Comma-separated report formats out of txt,root,pdf,json,csv
+ *                 (default: txt,root,pdf)
+ *   --watch       Validate the ladder, then keep re-checking what changes on
+ *                 disk until interrupted (Ctrl-C writes the final reports); single-ladder runs
+ *                 without --verdict-only or --cleanup=plan|apply
+ *   --watch-settle=MS  Quiet time before changes are re-checked (default 2000)
+ *   --pdf=full|summary  One PDF page per directory [default] or the summary
+ *                 page and a one-line-per-directory index
+ *   --batch=PATH[,PATH...]  Validate every ladder folder inside the given
+ *                 folders instead of the current directory (no cleanup)
+ *   --cleanup=interactive|plan|apply|none  Confirm deletions one group at a
+ *                 time [default], only write them to the manifest, delete
+ *                 everything listed in the manifest, or skip the cleanup
+ *                 and the second pass
+ *   --cleanup-policy=ask|auto-empty|auto-all  Interactive mode: delete empty
+ *                 files (or everything) without asking
+ *   --manifest=PATH  Cleanup manifest (default <ladder>/ExorcismCleanup_<ladder>.tsv)
+ *   --delete-workers=N  Deletions running at the same time (default 4)
+ *   --quarantine  Move cleaned-up files into <ladder>/.exorcism_quarantine_<time>
+ *                 instead of deleting them
+ *   --purge-quarantine  Delete the quarantine folders of earlier runs
+ *                 (in the background while validating)
+ *   --verdict-only  Directory statuses and the ladder verdict only
+ *   --verbosity=quiet|normal|verbose  Validator console output
+ *   --discover=marked|all  Validate only folders with a log file or check
+ *                 subfolders [default], or every folder
+ *   --include=GLOB[,GLOB...]  Only validate folders matching a pattern
+ *   --exclude=GLOB[,GLOB...]  Never validate folders matching a pattern
+ *   --resume      Take directories checkpointed by an interrupted run whose
+ *                 files did not change from its journal
+ *   --no-journal  Do not checkpoint validated directories
+ *   --shard=I/N   Batch mode: validate only the ladders of shard I (0..N-1)
+ *                 and write their counters to an ExorcismShard_ file
+ *   --merge-shards=PATH[,PATH...]  Combine shard files (or the newest
+ *                 ones inside folders) into one campaign summary
+ *   --diff[=PATH]  Delta report against an earlier ROOT report (default: the
+ *                 newest ExorcismReport_<ladder>*_before.root); implies
+ *                 --formats=root, --verbosity=quiet and --cleanup=none unless
+ *                 those are given. Single-ladder runs only.
+ *
+ * Returns:
+ *   false if any option was not recognised or can't be used (Exorcism()
+ *   then stops; invalid values fall back to the defaults)
+ */
+bool ParseOptions(const TString& options) {
+    gOptions = ExorcismOptions();  // Start from defaults on every run
+
+    std::istringstream stream(options.Data());
+    std::string token;
+    bool allValid = true;
+    bool formatsGiven = false, verbosityGiven = false, cleanupGiven = false;  // For the --diff defaults
+    while (stream >> token) {
+        std::string name = token;
+        std::string value;
+        size_t eqPos = token.find('=');
+        if (eqPos != std::string::npos) {
+            name = token.substr(0, eqPos);
+            value = token.substr(eqPos + 1);
+        }
+
+        if (name == "--workers") {
+            if (!ParseCount(value, gOptions.workers)) {
+                std::cerr << "Warning: Invalid worker count (use N >= 0): " << value << std::endl;
+                allValid = false;
+            }
+        } else if (name == "--root-check") {
+            if (value == "deep") {
+                gOptions.deepRootCheck = true;
+            } else if (value == "fast") {
+                gOptions.deepRootCheck = false;
+            } else {
+                std::cerr << "Warning: Unknown ROOT check mode (use fast or deep): " << value << std::endl;
+                allValid = false;
+            }
+        } else if (name == "--no-cache") {
+            gOptions.useCache = false;
+        } else if (name == "--cache-file") {
+            gOptions.cacheFile = value;
+        } else if (name == "--batch") {
+            std::istringstream paths(value);
+            std::string path;
+            while (std::getline(paths, path, ',')) {
+                if (!path.empty()) gOptions.batchRoots.push_back(path);
+            }
+            if (gOptions.batchRoots.empty()) {
+                std::cerr << "Warning: --batch needs at least one folder" << std::endl;
+                allValid = false;
+            }
+        } else if (name == "--cleanup") {
+            cleanupGiven = true;
+            if (value == "interactive") {
+                gOptions.cleanupMode = CLEANUP_INTERACTIVE;
+            } else if (value == "plan") {
+                gOptions.cleanupMode = CLEANUP_PLAN;
+            } else if (value == "apply") {
+                gOptions.cleanupMode = CLEANUP_APPLY;
+            } else if (value == "none") {
+                gOptions.cleanupMode = CLEANUP_NONE;
+            } else {
+                std::cerr << "Warning: Unknown cleanup mode (use interactive, plan, apply or none): "
+                          << value << std::endl;
+                allValid = false;
+            }
+        } else if (name == "--cleanup-policy") {
+            if (value == "ask") {
+                gOptions.cleanupPolicy = POLICY_ASK;
+            } else if (value == "auto-empty") {
+                gOptions.cleanupPolicy = POLICY_AUTO_EMPTY;
+            } else if (value == "auto-all") {
+                gOptions.cleanupPolicy = POLICY_AUTO_ALL;
+            } else {
+                std::cerr << "Warning: Unknown cleanup policy (use ask, auto-empty or auto-all): "
+                          << value << std::endl;
+                allValid = false;
+            }
+        } else if (name == "--manifest") {
+            gOptions.manifestFile = value;
+        } else if (name == "--delete-workers") {
+            if (!ParseCount(value, gOptions.deleteWorkers)) {
+                std::cerr << "Warning: Invalid delete worker count (use N >= 0): " << value << std::endl;
+                allValid = false;
+            }
+        } else if (name == "--quarantine") {
+            gOptions.quarantine = true;
+        } else if (name == "--purge-quarantine") {
+            gOptions.purgeQuarantine = true;
+        } else if (name == "--verdict-only") {
+            gOptions.verdictOnly = true;
+        } else if (name == "--resume") {
+            gOptions.resume = true;
+        } else if (name == "--no-journal") {
+            gOptions.journal = false;
+        } else if (name == "--shard") {
+            int index = -1, count = 0;
+            char extra = 0;
+            if (sscanf(value.c_str(), "%d/%d%c", &index, &count, &extra) == 2 && count > 0 && index >= 0 && index < count) {
+                gOptions.shardIndex = index;
+                gOptions.shardCount = count;
+            } else {
+                std::cerr << "Warning: Invalid shard (use I/N with 0 <= I < N): " << value << std::endl;
+                allValid = false;
+            }
+        } else if (name == "--merge-shards") {
+            std::istringstream paths(value);
+            std::string path;
+            while (std::getline(paths, path, ',')) {
+                if (!path.empty()) gOptions.shardResults.push_back(path);
+            }
+            if (gOptions.shardResults.empty()) {
+                std::cerr << "Warning: --merge-shards needs at least one file or folder" << std::endl;
+                allValid = false;
+            }
+        } else if (name == "--diff") {
+            gOptions.diff = true;
+            gOptions.diffBase = value;
+        } else if (name == "--discover") {
+            if (value == "marked") {
+                gOptions.discoverAll = false;
+            } else if (value == "all") {
+                gOptions.discoverAll = true;
+            } else {
+                std::cerr << "Warning: Unknown discovery mode (use marked or all): " << value << std::endl;
+                allValid = false;
+            }
+        } else if (name == "--include" || name == "--exclude") {
+            std::vector<std::string>& globs = (name == "--include") ? gOptions.includeGlobs : gOptions.excludeGlobs;
+            std::istringstream patterns(value);
+            std::string pattern;
+            while (std::getline(patterns, pattern, ',')) {
+                if (!pattern.empty()) globs.push_back(pattern);
+            }
+        } else if (name == "--verbosity") {
+            verbosityGiven = true;
+            if (value == "quiet") {
+                gOptions.verbosity = VERBOSITY_QUIET;
+            } else if (value == "normal") {
+                gOptions.verbosity = VERBOSITY_NORMAL;
+            } else if (value == "verbose") {
+                gOptions.verbosity = VERBOSITY_VERBOSE;
+            } else {
+                std::cerr << "Warning: Unknown verbosity (use quiet, normal or verbose): " << value << std::endl;
+                allValid = false;
+            }
+        } else if (name == "--watch") {
+            gOptions.watch = true;
+        } else if (name == "--watch-settle") {
+            /* Bounded so the maximum delay (10 settle times) can't overflow */
+            if (!ParseCount(value, gOptions.watchSettleMs, INT_MAX / 10)) {
+                std::cerr << "Warning: Invalid settle time (use milliseconds >= 0): " << value << std::endl;
+                allValid = false;
+            }
+        } else if (name == "--pdf") {
+            if (value == "full") {
+                gOptions.pdfSummaryOnly = false;
+            } else if (value == "summary") {
+                gOptions.pdfSummaryOnly = true;
+            } else {
+                std::cerr << "Warning: Unknown PDF mode (use full or summary): " << value << std::endl;
+                allValid = false;
+            }
+        } else if (name == "--formats") {
+            formatsGiven = true;
+            gOptions.formats = ParseFormats(value);
+            if (gOptions.formats == 0) {
+                std::cerr << "Warning: No valid report format in: " << value << std::endl;
+                gOptions.formats = FORMAT_DEFAULT;
+                allValid = false;
+            }
+        } else {
+            std::cerr << "Warning: Unknown option: " << token << std::endl;
+            allValid = false;
+        }
+    }
+
+    if (gOptions.shardCount > 1 && gOptions.batchRoots.empty()) {
+        std::cerr << "Warning: --shard only applies to --batch" << std::endl;
+        gOptions.shardIndex = 0;
+        gOptions.shardCount = 1;
+        allValid = false;
+    }
+
+    /* Watch mode re-validates one ladder in place and writes complete reports, without cleanup */
+    if (gOptions.watch && (!gOptions.batchRoots.empty() || !gOptions.shardResults.empty() ||
+                           gOptions.verdictOnly || gOptions.cleanupMode == CLEANUP_PLAN ||
+                           gOptions.cleanupMode == CLEANUP_APPLY)) {
+        std::cerr << "Warning: --watch does not apply to --batch, --merge-shards, --verdict-only or "
+                     "--cleanup=plan|apply" << std::endl;
+        gOptions.watch = false;
+        allValid = false;
+    }
+
+    /* The delta report compares the first pass of a single-ladder run */
+    if (gOptions.diff && (!gOptions.batchRoots.empty() || gOptions.watch || gOptions.verdictOnly ||
+                          !gOptions.shardResults.empty())) {
+        std::cerr << "Warning: --diff does not apply to --batch, --watch, --verdict-only or --merge-shards"
+                  << std::endl;
+        gOptions.diff = false;
+        allValid = false;
+    }
+
+    /* A routine delta run only keeps the ROOT report, the next run's baseline */
+    if (gOptions.diff) {
+        if (!formatsGiven) gOptions.formats = FORMAT_ROOT;
+        if (!verbosityGiven) gOptions.verbosity = VERBOSITY_QUIET;
+        if (!cleanupGiven) gOptions.cleanupMode = CLEANUP_NONE;
+    }
+
+    /* Page-based reports would hold incomplete file lists */
+    if (gOptions.verdictOnly) gOptions.formats &= FORMAT_STREAMS;
+    return allValid;
+}
+
+/*
+ * PrintUsage:
+ * Short option overview, printed when an option was rejected
+ */
+void PrintUsage() {
+    std::cerr << "\nUsage: exorcism [options]   (macro: root 'Exorcism.C(\"[options]\")')\n"
+        "  --workers=N                 Validation threads (1 = sequential, 0 = one per core)\n"
+        "  --root-check=fast|deep      ROOT file check by header or with TFile::Open\n"
+        "  --no-cache                  Do not read or write the validation cache\n"
+        "  --cache-file=PATH           Validation cache location\n"
+        "  --formats=LIST              Reports out of txt,root,pdf,json,csv\n"
+        "  --pdf=full|summary          PDF with one page per directory or an index only\n"
+        "  --verbosity=quiet|normal|verbose  Validator console output\n"
+        "  --verdict-only              Statuses and ladder verdict only, exit with the worst\n"
+        "  --discover=marked|all       Which folders are test directories\n"
+        "  --include=GLOB[,GLOB...]    Only validate matching folders\n"
+        "  --exclude=GLOB[,GLOB...]    Never validate matching folders\n"
+        "  --watch, --watch-settle=MS  Keep re-checking the ladder as files change\n"
+        "  --batch=PATH[,PATH...]      Validate every ladder inside the folders\n"
+        "  --shard=I/N                 Batch mode: validate shard I of N\n"
+        "  --merge-shards=PATH[,PATH...]  Combine shard results\n"
+        "  --cleanup=interactive|plan|apply|none  How problem files are removed\n"
+        "  --cleanup-policy=ask|auto-empty|auto-all  Interactive cleanup without asking\n"
+        "  --manifest=PATH             Cleanup manifest for plan and apply\n"
+        "  --delete-workers=N          Deletions running at the same time\n"
+        "  --quarantine                Move cleaned-up files aside instead of deleting\n"
+        "  --purge-quarantine          Delete quarantine folders of earlier runs\n"
+        "  --resume, --no-journal      Resume an interrupted run / no checkpoints\n"
+        "  --diff[=PATH]               Delta report against an earlier ROOT report\n"
+        "See README.md for details." << std::endl;
+}
+
+// ===================================================================
+// Batch Mode
+// ===================================================================
+/*
+ * LadderRun Structure:
+ * One ladder of a batch run, with its own state instead of gState
+ */
+struct LadderRun {
+    TString path;                      // Absolute path of the ladder folder
+    std::vector<TString> directories;  // Validation directories inside it
+    GlobalState state;                 // Counters, report pages and summary of this ladder
+    PendingValidations pending;        // Checks queued on the shared pool
+};
+
+/*
+ * ShardOf:
+ * Shard of a ladder by rendezvous (highest random weight) hashing of its
+ * key: every job computes the same disjoint split without coordination,
+ * and going from N to N+1 shards only moves the ladders the new shard takes
+ */
+int ShardOf(std::string_view key, int shardCount) {
+    int best = 0;
+    ULong64_t bestWeight = 0;
+    for (int shard = 0; shard < shardCount; shard++) {
+        ULong64_t weight = StableHash(key, (ULong64_t)shard + 1);
+        if (shard == 0 || weight > bestWeight) {
+            best = shard;
+            bestWeight = weight;
+        }
+    }
+    return best;
+}
+
+/*
+ * FindBatchLadders:
+ * Lists the ladder folders inside each batch root: every (non-system)
+ * subfolder that holds validation directories. With --shard only the
+ * ladders of this shard, keyed by "<batch folder name>/<ladder name>" so
+ * that nodes mounting the archive at different paths split it the same way.
+ */
+std::vector<LadderRun> FindBatchLadders(const std::vector<std::string>& roots) {
+    std::vector<LadderRun> ladders;
+    for (const auto& root : roots) {
+        // Absolute, normalized path: reports and cache keys stay stable
+        char* resolved = realpath(root.c_str(), nullptr);
+        if (!resolved || !DirectoryExists(resolved)) {
+            std::cerr << "Error: Batch folder does not exist: " << root << std::endl;
+            free(resolved);
+            continue;
+        }
+        TString rootPath = resolved;
+        free(resolved);
+        std::string rootName = gSystem->BaseName(rootPath);
+
+        std::vector<std::string> names;
+        ListSubdirectories(rootPath, names);
+        for (const auto& name : names) {
+            if (IsSystemFolder(name)) continue;
+            if (gOptions.shardCount > 1 && ShardOf(rootName + "/" + name, gOptions.shardCount) != gOptions.shardIndex) {
+                continue;  // Another job's ladder
+            }
+            TString ladderName = name.c_str();
+            LadderRun ladder;
+            ladder.path = rootPath + "/" + ladderName;
+            ladder.directories = FindValidationDirectories(ladder.path, false);
+            if (ladder.directories.empty()) continue;  // Not a ladder folder
+            ladder.state.currentLadder = ladderName.Data();
+            ladders.push_back(std::move(ladder));
+        }
+    }
+
+    // Fixed campaign order, independent of the directory listing order
+    std::sort(ladders.begin(), ladders.end(), [](const LadderRun& a, const LadderRun& b) {
+        return a.path < b.path;
+    });
+    return ladders;
+}
+
+/*
+ * SaveCampaignSummary:
+ * Writes one line per ladder of the batch plus campaign totals
+ * to a text file (and the console)
+ */
+void SaveCampaignSummary(const TString& filename, const std::vector<LadderRun>& ladders) {
+    std::stringstream table;
+    table << std::left << std::setw(40) << "Ladder" << std::right
+          << std::setw(7) << "Dirs" << std::setw(12) << "Consistent" << std::setw(11) << "Auxiliary"
+          << std::setw(12) << "Miss/Extra" << std::setw(8) << "Errors" << std::setw(10) << "Success" << "\n";
+
+    GlobalState total;
+    auto addRow = [&table](const std::string& name, const GlobalState& state) {
+        int dirs = state.goodDirs + state.auxDirs + state.missextraDirs + state.errorDirs;
+        float successRate = (dirs > 0) ? (100.0f * (state.goodDirs + state.auxDirs) / dirs) : 0.0f;
+        table << std::left << std::setw(40) << name << std::right
+              << std::setw(7) << dirs << std::setw(12) << state.goodDirs << std::setw(11) << state.auxDirs
+              << std::setw(12) << state.missextraDirs << std::setw(8) << state.errorDirs
+              << std::setw(9) << std::fixed << std::setprecision(1) << successRate << "%\n";
+    };
+
+    for (const auto& ladder : ladders) {
+        addRow(ladder.path.Data(), ladder.state);
+        total.goodDirs += ladder.state.goodDirs;
+        total.auxDirs += ladder.state.auxDirs;
+        total.missextraDirs += ladder.state.missextraDirs;
+        total.errorDirs += ladder.state.errorDirs;
+    }
+    table << std::string(100, '-') << "\n";
+    addRow("TOTAL", total);
+
+    std::cout << "\n===== CAMPAIGN SUMMARY =====" << std::endl;
+    std::cout << table.str() << std::endl;
+
+    std::ofstream out(filename.Data());
+    if (!out.is_open()) {
+        std::cerr << "Error: Could not open campaign summary for writing: " << filename << std::endl;
+        return;
+    }
+    out << "=======================================================\n";
+    out << "      EXORCISM CAMPAIGN SUMMARY\n";
+    out << "=======================================================\n\n";
+    out << "Report generated: " << FormatCurrentTime("%b %e %Y %H:%M:%S") << "\n";
+    out << "Ladders validated: " << ladders.size() << "\n";
+    out << "-------------------------------------------------------\n\n";
+    out << table.str();
+    out.close();
+
+    if (out.fail()) {
+        std::cerr << "Warning: Potential write error during campaign summary generation: "
+                  << filename << std::endl;
+    } else {
+        std::cout << "Campaign summary saved to: " << filename << std::endl;
+    }
+}
+
+/*
+ * SaveShardResults:
+ * Writes the counters of every ladder of this shard, the partial result
+ * that --merge-shards combines:
+ *   # EXORCISM shard results v1
+ *   shard <index> <count>
+ *   <consistent> <auxiliary> <missing/extra> <errors> <ladder path>
+ * (tab-separated)
+ */
+void SaveShardResults(const TString& filename, const std::vector<LadderRun>& ladders) {
+    std::ofstream out(filename.Data());
+    if (!out.is_open()) {
+        std::cerr << "Error: Could not open shard results for writing: " << filename << std::endl;
+        return;
+    }
+    out << SHARD_RESULTS_HEADER << "\n";
+    out << "shard\t" << gOptions.shardIndex << "\t" << gOptions.shardCount << "\n";
+    for (const auto& ladder : ladders) {
+        const GlobalState& state = ladder.state;
+        out << state.goodDirs << "\t" << state.auxDirs << "\t" << state.missextraDirs << "\t"
+            << state.errorDirs << "\t" << ladder.path << "\n";
+    }
+    out.close();
+
+    if (out.fail()) {
+        std::cerr << "Warning: Potential write error during shard results generation: " << filename << std::endl;
+    } else {
+        std::cout << "Shard results saved to: " << filename << std::endl;
+    }
+}
+
+/*
+ * ReadShardResults:
+ * Reads a file written by SaveShardResults into ladders (counters only)
+ *
+ * Returns:
+ *   false if the file can't be read or has an unknown format
+ */
+bool ReadShardResults(const std::string& path, std::vector<LadderRun>& ladders, int& shardIndex, int& shardCount) {
+    std::ifstream in(path.c_str());
+    if (!in.is_open()) {
+        std::cerr << "Error: Could not read shard results: " << path << std::endl;
+        return false;
+    }
+    std::string line, tag;
+    if (!std::getline(in, line) || line != SHARD_RESULTS_HEADER ||
+        !std::getline(in, line) || !(std::istringstream(line) >> tag >> shardIndex >> shardCount) ||
+        tag != "shard" || shardCount < 1 || shardIndex < 0 || shardIndex >= shardCount) {
+        std::cerr << "Error: Not a shard results file: " << path << std::endl;
+        return false;
+    }
+
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        LadderRun ladder;
+        GlobalState& state = ladder.state;
+        std::string ladderPath;
+        if (!(fields >> state.goodDirs >> state.auxDirs >> state.missextraDirs >> state.errorDirs)) continue;
+        fields.ignore(1);  // Tab before the path
+        if (!std::getline(fields, ladderPath) || ladderPath.empty()) continue;
+        ladder.path = ladderPath.c_str();
+        ladders.push_back(std::move(ladder));
+    }
+    return true;
+}
+
+/*
+ * RunBatch:
+ * Validates every ladder found in gOptions.batchRoots.
+ *
+ * Operation:
+ * 1. Discovers ladders and their validation directories
+ * 2. Queues the checks of all ladders on one shared, bounded pool, so
+ *    ladders are validated concurrently and startup is paid once
+ * 3. Merges each ladder into its own state in a fixed order; detailed
+ *    validator output goes to the reports only, not the console
+ * 4. Writes per-ladder reports into each ladder folder and a campaign
+ *    summary into the current directory
+ *
+ * No interactive cleanup is done in batch mode.
+ *
+ * Returns:
+ *   Verdict-only mode: the worst STATUS_* level of the campaign, else 0
+ */
+int RunBatch() {
+    std::cout << "Starting EXORCISM batch validation" << std::endl;
+    if (gOptions.shardCount > 1) {
+        std::cout << "Shard " << gOptions.shardIndex << " of " << gOptions.shardCount
+                  << " (shards 0-" << gOptions.shardCount - 1 << ")" << std::endl;
+    }
+    std::cout << "====================================================" << std::endl;
+
+    TString timestamp = TString::Format("_%s", FormatCurrentTime("%b %e %Y_%H:%M:%S").c_str());
+    timestamp.ReplaceAll(" ", "_");  // Fix spaces in date
+    timestamp.ReplaceAll(":", "-");  // Fix colons in time
+    TString shardTag = (gOptions.shardCount > 1)
+        ? TString::Format("_shard%dof%d", gOptions.shardIndex, gOptions.shardCount) : TString("");
+    TString shardResults = TString::Format("ExorcismShard_%dof%d%s.tsv", gOptions.shardIndex,
+                                           gOptions.shardCount, timestamp.Data());
+
+    std::vector<LadderRun> ladders = FindBatchLadders(gOptions.batchRoots);
+    if (ladders.empty()) {
+        std::cout << "No ladder folders found!" << std::endl;
+        // An empty shard still reports, so the merge knows it ran
+        if (gOptions.shardCount > 1) {
+            SaveShardResults(shardResults, ladders);
+            return 0;
+        }
+        return gOptions.verdictOnly ? STATUS_DIRECTORY_ERROR : 0;
+    }
+
+    /* One cache for the whole campaign (paths in it are absolute) */
+    OpenValidationCache(gSystem->GetDirName(ladders.front().path.Data()).Data());
+
+    size_t totalDirs = 0;
+    for (const auto& ladder : ladders) totalDirs += ladder.directories.size();
+
+    int nWorkers = ResolveWorkerCount(gOptions.workers);
+    std::cout << "Validating " << ladders.size() << " ladders (" << totalDirs
+              << " directories) with " << nWorkers << " worker threads" << std::endl;
+    if (nWorkers > 1) {
+        ROOT::EnableThreadSafety();  // TFile::Open may be called from several threads
+    }
+
+    ThreadPool pool(nWorkers);
+    for (auto& ladder : ladders) {
+        std::vector<DirectoryValidation> validations(ladder.directories.size());
+        for (size_t i = 0; i < ladder.directories.size(); i++) {
+            validations[i].dirName = ladder.directories[i];
+        }
+        std::vector<int> checkMasks(validations.size(), CHECK_ALL);
+        ladder.state.journal = OpenJournal(ladder.path);
+        if (ladder.state.journal) ladder.state.journal->Resume(validations, checkMasks);
+        ladder.pending = SubmitValidations(pool, std::move(validations), checkMasks, ladder.path);
+    }
+
+    /* Merge and report ladder by ladder while later ladders are still running */
+    for (auto& ladder : ladders) {
+        std::cout << "\n===== LADDER " << ladder.state.currentLadder << " =====" << std::endl;
+        TString report = TString::Format("%s/ExorcismReport_%s%s_batch", ladder.path.Data(),
+                                         ladder.state.currentLadder.c_str(), timestamp.Data());
+        ladder.state.stream = OpenResultStream(report);
+
+        MergeValidations(ladder.pending, ladder.state, false);
+        GenerateGlobalSummary(ladder.directories.size(), ladder.state);
+        SaveReports(report, ladder.state);
+        if (ladder.state.journal) ladder.state.journal->Remove();
+
+        // Only the counters are needed from here on
+        ladder.state.results.clear();
+        ladder.state.reportPages.clear();
+        ladder.state.stream.reset();
+        ladder.state.journal.reset();
+    }
+    SaveValidationCache();
+
+    WaitForPdfReports();
+    SaveCampaignSummary(TString::Format("ExorcismCampaign%s%s.txt", shardTag.Data(), timestamp.Data()), ladders);
+    if (gOptions.shardCount > 1) {
+        SaveShardResults(shardResults, ladders);
+    }
+
+    if (!gCache.filePath.empty()) {
+        std::cout << "\nValidation cache: " << gCache.hits << " verdicts reused, "
+                  << gCache.misses << " files checked (" << gCache.filePath << ")" << std::endl;
+    }
+
+    PrintProfile();
+
+    int worst = STATUS_DATA_CONSISTENT;
+    for (const auto& ladder : ladders) worst = std::max(worst, WorstStatus(ladder.state));
+    if (!gOptions.verdictOnly) return 0;
+    return PrintVerdict(worst);
+}
+
+/*
+ * RunShardMerge:
+ * Combines the shard results of a sharded batch run into one campaign
+ * summary. Folders in gOptions.shardResults stand for the ExorcismShard_
+ * files inside them; if a shard appears more than once (a job was re-run),
+ * its newest file is used.
+ *
+ * Returns:
+ *   0, or with --verdict-only the worst status (a directory error if a
+ *   shard is missing)
+ */
+int RunShardMerge() {
+    std::cout << "Merging EXORCISM shard results" << std::endl;
+    std::cout << "====================================================" << std::endl;
+
+    std::vector<std::string> files;
+    for (const auto& path : gOptions.shardResults) {
+        if (!DirectoryExists(path.c_str())) {
+            files.push_back(path);  // A file; reported by ReadShardResults if missing
+            continue;
+        }
+        for (const auto& entry : GetDirectorySnapshot(path.c_str()).entries) {
+            if (!entry.isDirectory && HasPrefix(entry.name, "ExorcismShard_") && HasSuffix(entry.name, ".tsv")) {
+                files.push_back(path + "/" + entry.name);
+            }
+        }
+    }
+
+    struct ShardFile {
+        std::string path;
+        Long_t mtime = 0;
+        std::vector<LadderRun> ladders;
+    };
+    std::map<int, ShardFile> shards;  // Shard index -> newest results
+    int shardCount = 0;
+    for (const auto& file : files) {
+        ShardFile shard;
+        int index = 0, count = 0;
+        if (!ReadShardResults(file, shard.ladders, index, count)) continue;
+        if (shardCount == 0) shardCount = count;
+        if (count != shardCount) {
+            std::cerr << "Error: " << file << " belongs to a run with " << count << " shards, not "
+                      << shardCount << "; ignored" << std::endl;
+            continue;
+        }
+        struct stat st;
+        shard.mtime = (stat(file.c_str(), &st) == 0) ? st.st_mtime : 0;
+        shard.path = file;
+
+        auto old = shards.find(index);
+        if (old != shards.end()) {
+            bool newer = shard.mtime > old->second.mtime;
+            std::cerr << "Warning: Shard " << index << " found twice, using the newer "
+                      << (newer ? shard.path : old->second.path) << std::endl;
+            if (!newer) continue;
+        }
+        shards[index] = std::move(shard);
+    }
+
+    if (shards.empty()) {
+        std::cout << "No shard results found!" << std::endl;
+        return gOptions.verdictOnly ? STATUS_DIRECTORY_ERROR : 0;
+    }
+
+    std::vector<LadderRun> ladders;
+    for (auto& shard : shards) {
+        std::cout << "Shard " << shard.first << ": " << shard.second.ladders.size() << " ladders ("
+                  << shard.second.path << ")" << std::endl;
+        for (auto& ladder : shard.second.ladders) ladders.push_back(std::move(ladder));
+    }
+    int missing = shardCount - (int)shards.size();
+    for (int index = 0; index < shardCount; index++) {
+        if (!shards.count(index)) {
+            std::cerr << "Warning: No results for shard " << index << " of " << shardCount
+                      << ", the summary is incomplete" << std::endl;
+        }
+    }
+
+    // Same order as a single batch run
+    std::sort(ladders.begin(), ladders.end(), [](const LadderRun& a, const LadderRun& b) {
+        return a.path < b.path;
+    });
+
+    TString timestamp = TString::Format("_%s", FormatCurrentTime("%b %e %Y_%H:%M:%S").c_str());
+    timestamp.ReplaceAll(" ", "_");  // Fix spaces in date
+    timestamp.ReplaceAll(":", "-");  // Fix colons in time
+    SaveCampaignSummary(TString::Format("ExorcismCampaign%s.txt", timestamp.Data()), ladders);
+
+    int worst = (missing > 0) ? STATUS_DIRECTORY_ERROR : STATUS_DATA_CONSISTENT;
+    for (const auto& ladder : ladders) worst = std::max(worst, WorstStatus(ladder.state));
+    if (!gOptions.verdictOnly) return 0;
+    return PrintVerdict(worst);
+}
+
+// ===================================================================
+// Verdict Mode
+// ===================================================================
+/*
+ * RunVerdict:
+ * Answers "is this ladder shippable?" without a full validation: the
+ * validators stop as soon as a directory's status is final and skip
+ * content checks once names or counts already failed. One status line
+ * is printed per directory; there is no cleanup, and only the JSON/CSV
+ * streams can be written (their file lists are incomplete).
+ *
+ * Returns:
+ *   The worst STATUS_* level of the ladder, the executable's exit code:
+ *   0 consistent, 1 auxiliary files only, 2 missing/extra, 3 directory error
+ */
+int RunVerdict(const std::vector<TString>& directories) {
+    TString timestamp = TString::Format("_%s", FormatCurrentTime("%b %e %Y_%H:%M:%S").c_str());
+    timestamp.ReplaceAll(" ", "_");  // Fix spaces in date
+    timestamp.ReplaceAll(":", "-");  // Fix colons in time
+    TString report = TString::Format("ExorcismVerdict_%s%s", gState.currentLadder.c_str(), timestamp.Data());
+    gState.stream = OpenResultStream(report);
+
+    ValidateDirectories(directories);
+
+    std::cout << "\n===== DIRECTORY VERDICTS =====" << std::endl;
+    for (const auto& validation : gState.results) {
+        std::string statusStr;
+        EvaluateDirectoryStatus(validation, statusStr);
+        std::cout << std::left << std::setw(40) << validation.dirName.Data() << std::right
+                  << statusStr << std::endl;
+    }
+    GenerateGlobalSummary(directories.size());
+
+    int worst = PrintVerdict(WorstStatus(gState));
+
+    SaveReports(report);
+    SaveValidationCache();
+    if (gOptions.formats) {
+        std::cout << "\nVerdict reports:" << std::endl;
+        PrintReportNames(report);
+    }
+
+    PrintProfile();
+    return worst;
+}
+
+// ===================================================================
+// Watch Mode
+// ===================================================================
+
+volatile sig_atomic_t gWatchStop = 0;  // Set by SIGINT/SIGTERM in watch mode
+
+/*
+ * StopWatching:
+ * Signal handler ending watch mode after the current update
+ */
+void StopWatching(int) {
+    gWatchStop = 1;
+}
+
+#ifdef __linux__
+#define WATCH_EVENTS (IN_CREATE | IN_DELETE | IN_CLOSE_WRITE | IN_MOVED_FROM | IN_MOVED_TO | IN_ATTRIB)
+
+/*
+ * LadderWatcher:
+ * inotify watches on the ladder folder, every test directory and its
+ * trim_files/pscan_files/conn_check_files subfolders. Events are turned
+ * into "directory -> CHECK_* mask" changes: a file landing in pscan_files
+ * only re-runs CheckPscanFiles for that directory.
+ */
+class LadderWatcher {
+public:
+    explicit LadderWatcher(const TString& ladderDir) : ladder(ladderDir.Data()) {
+        fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (fd >= 0) AddWatch(ladder, "", "");
+    }
+
+    ~LadderWatcher() {
+        if (fd >= 0) close(fd);
+    }
+
+    LadderWatcher(const LadderWatcher&) = delete;
+    LadderWatcher& operator=(const LadderWatcher&) = delete;
+
+    bool IsOpen() const { return fd >= 0; }
+
+    // Watches a test directory and those of its subfolders that exist
+    void WatchDirectory(const TString& dirName) {
+        std::string dir = ladder + "/" + dirName.Data();
+        AddWatch(dir, dirName, "");
+        for (const char* subdir : {"trim_files", "pscan_files", "conn_check_files"}) {
+            AddWatch(dir + "/" + subdir, dirName, subdir);
+        }
+    }
+
+    /*
+     * Waits up to timeoutMs for events and adds them to changes. rescan is
+     * set when test directories may have appeared or disappeared.
+     * Returns the number of events read, 0 on timeout or signal, -1 on error.
+     */
+    int Poll(int timeoutMs, std::map<TString, int>& changes, bool& rescan) {
+        struct pollfd pfd = {fd, POLLIN, 0};
+        int ready = poll(&pfd, 1, timeoutMs);
+        if (ready < 0) return (errno == EINTR) ? 0 : -1;
+        if (ready == 0) return 0;
+
+        int nEvents = 0;
+        alignas(struct inotify_event) char buffer[64 * 1024];
+        while (true) {
+            ssize_t length = read(fd, buffer, sizeof(buffer));
+            if (length <= 0) break;  // EAGAIN: queue drained
+            for (char* pos = buffer; pos < buffer + length; ) {
+                const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(pos);
+                pos += sizeof(struct inotify_event) + event->len;
+                nEvents++;
+                HandleEvent(*event, changes, rescan);
+            }
+        }
+        return nEvents;
+    }
+
+private:
+    // Where a watch descriptor points to; dirName "" = the ladder folder
+    struct WatchTarget {
+        TString dirName;  // Test directory
+        TString subdir;   // "" = the test directory itself
+    };
+
+    void AddWatch(const std::string& path, const TString& dirName, const TString& subdir) {
+        int wd = inotify_add_watch(fd, path.c_str(), WATCH_EVENTS);
+        if (wd >= 0) {
+            targets[wd] = {dirName, subdir};
+        } else if (errno != ENOENT) {
+            std::cerr << "Warning: Cannot watch " << path << ": " << strerror(errno) << std::endl;
+        }
+    }
+
+    void HandleEvent(const struct inotify_event& event, std::map<TString, int>& changes, bool& rescan) {
+        if (event.mask & IN_Q_OVERFLOW) {
+            // Events were lost: treat every directory as changed
+            rescan = true;
+            for (const auto& target : targets) {
+                if (!target.second.dirName.IsNull()) changes[target.second.dirName] |= CHECK_ALL;
+            }
+            return;
+        }
+        auto it = targets.find(event.wd);
+        if (it == targets.end()) return;
+        if (event.mask & IN_IGNORED) {
+            targets.erase(it);  // Watched folder was removed
+            return;
+        }
+
+        WatchTarget target = it->second;
+        TString name = event.len ? event.name : "";
+        bool isDir = (event.mask & IN_ISDIR) != 0;
+        bool appeared = (event.mask & (IN_CREATE | IN_MOVED_TO)) != 0;
+
+        if (target.dirName.IsNull()) {
+            // Ladder folder: only (non-hidden) test directories matter
+            if (!isDir || name.BeginsWith(".")) return;
+            rescan = true;
+            changes[name] |= CHECK_ALL;
+            if (appeared) WatchDirectory(name);
+        } else if (target.subdir.IsNull()) {
+            // Test directory: log files, or one of the check subfolders
+            int mask = isDir ? CheckMaskForFolder(name) : CHECK_LOG;
+            if (isDir && mask == CHECK_LOG) return;  // Other folders are not validated
+            changes[target.dirName] |= mask;
+            if (isDir && appeared) {
+                AddWatch(ladder + "/" + target.dirName.Data() + "/" + name.Data(), target.dirName, name);
+            }
+        } else {
+            changes[target.dirName] |= CheckMaskForFolder(target.subdir);
+        }
+    }
+
+    int fd = -1;                                    // inotify instance
+    std::string ladder;                             // Ladder folder path
+    std::unordered_map<int, WatchTarget> targets;   // Watch descriptor -> folder
+};
+#endif
+
+/*
+ * PrintWatchStatus:
+ * One-line summary of the live state
+ */
+void PrintWatchStatus() {
+    std::cout << "[" << FormatCurrentTime("%H:%M:%S") << "] " << gState.results.size() << " directories: "
+              << gState.goodDirs << " consistent, " << gState.auxDirs << " auxiliary, "
+              << gState.missextraDirs << " missing/extra, " << gState.errorDirs << " errors" << std::endl;
+}
+
+/*
+ * ApplyWatchChanges:
+ * Re-runs the validators selected in changes (directory -> CHECK_* mask)
+ * on fresh directory listings, carries all other results over and prints
+ * every directory whose status changed. With rescan the list of test
+ * directories is rebuilt as well.
+ */
+void ApplyWatchChanges(const TString& ladderDir, const std::map<TString, int>& changes, bool rescan) {
+    for (const auto& change : changes) {
+        ForgetDirectorySnapshots(ladderDir + "/" + change.first);
+    }
+
+    std::vector<DirectoryValidation> previous = std::move(gState.results);
+    std::map<TString, std::string> oldStatus;
+    std::map<TString, size_t> oldIndex;
+    for (size_t i = 0; i < previous.size(); i++) {
+        EvaluateDirectoryStatus(previous[i], oldStatus[previous[i].dirName]);
+        oldIndex[previous[i].dirName] = i;
+    }
+
+    // A folder gets validated once it has a test-run structure, usually
+    // some time after it was created
+    for (const auto& change : changes) {
+        if (!oldIndex.count(change.first)) rescan = true;
+    }
+
+    std::vector<TString> directories;
+    if (rescan) {
+        directories = FindValidationDirectories(ladderDir, false);
+    } else {
+        for (const auto& validation : previous) directories.push_back(validation.dirName);
+    }
+
+    std::vector<DirectoryValidation> validations(directories.size());
+    std::vector<int> checkMasks(directories.size(), CHECK_ALL);
+    for (size_t i = 0; i < directories.size(); i++) {
+        auto old = oldIndex.find(directories[i]);
+        auto change = changes.find(directories[i]);
+        if (old != oldIndex.end()) {
+            validations[i] = std::move(previous[old->second]);
+            checkMasks[i] = (change != changes.end()) ? change->second : 0;  // 0 = carried over
+        } else {
+            validations[i].dirName = directories[i];  // New test directory: all checks
+        }
+    }
+
+    std::string ladderName = gState.currentLadder;
+    gState = GlobalState();
+    gState.currentLadder = ladderName;
+    RunValidations(std::move(validations), checkMasks);
+
+    // Report what changed
+    std::set<TString> present;
+    for (const auto& validation : gState.results) {
+        present.insert(validation.dirName);
+        std::string status;
+        EvaluateDirectoryStatus(validation, status);
+        auto old = oldStatus.find(validation.dirName);
+        if (old == oldStatus.end()) {
+            std::cout << "  " << validation.dirName << ": new, " << status << std::endl;
+        } else if (old->second != status) {
+            std::cout << "  " << validation.dirName << ": " << old->second << " -> " << status << std::endl;
+        }
+    }
+    for (const auto& old : oldStatus) {
+        if (!present.count(old.first)) std::cout << "  " << old.first << ": removed" << std::endl;
+    }
+    PrintWatchStatus();
+    SaveValidationCache();
+}
+
+/*
+ * RunWatch:
+ * Validates the ladder once, then waits for file system events and
+ * re-checks only the affected validators of the affected directories
+ * (after --watch-settle ms without further events, at the latest after ten
+ * times that while writes keep coming). Ctrl-C ends the loop and the
+ * reports of the final state are written. No cleanup is done.
+ */
+void RunWatch() {
+#ifdef __linux__
+    TString ladderDir = gSystem->WorkingDirectory();
+    LadderWatcher watcher(ladderDir);
+    if (!watcher.IsOpen()) {
+        std::cerr << "Error: Cannot start watch mode (inotify): " << strerror(errno) << std::endl;
+        return;
+    }
+
+    std::string ladderName = gState.currentLadder;
+    gState = GlobalState();
+    gState.currentLadder = ladderName;
+
+    // Watches are in place before the first pass, so nothing landing during it is missed
+    std::vector<TString> directories = FindValidationDirectories(ladderDir);
+    for (const auto& dir : directories) watcher.WatchDirectory(dir);
+
+    std::cout << "\n===== WATCH MODE (Ctrl-C to stop) =====" << std::endl;
+    ValidateDirectories(directories);
+    SaveValidationCache();
+    PrintWatchStatus();
+
+    gWatchStop = 0;
+    struct sigaction action = {}, oldInt = {}, oldTerm = {};
+    action.sa_handler = StopWatching;  // No SA_RESTART: poll() returns on the signal
+    sigaction(SIGINT, &action, &oldInt);
+    sigaction(SIGTERM, &action, &oldTerm);
+
+    std::map<TString, int> changes;
+    bool rescan = false;
+    auto firstChange = std::chrono::steady_clock::now();
+    int maxDelayMs = 10 * gOptions.watchSettleMs;
+    while (!gWatchStop) {
+        bool pending = rescan || !changes.empty();
+        int nEvents = watcher.Poll(pending ? gOptions.watchSettleMs : 1000, changes, rescan);
+        if (nEvents < 0) {
+            std::cerr << "Error: Reading file system events failed: " << strerror(errno) << std::endl;
+            break;
+        }
+        if (!pending && (rescan || !changes.empty())) firstChange = std::chrono::steady_clock::now();
+        if (!(rescan || !changes.empty())) continue;
+
+        // Apply once writes have settled, or after the maximum delay
+        int waitedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - firstChange).count();
+        if (nEvents > 0 && waitedMs < maxDelayMs) continue;
+
+        std::cout << "\n[" << FormatCurrentTime("%H:%M:%S") << "] Re-checking "
+                  << changes.size() << " changed directories" << std::endl;
+        ApplyWatchChanges(ladderDir, changes, rescan);
+        changes.clear();
+        rescan = false;
+    }
+    sigaction(SIGINT, &oldInt, nullptr);
+    sigaction(SIGTERM, &oldTerm, nullptr);
+
+    // Final reports of the live state
+    std::cout << "\nWatch mode stopped, saving reports of the current state..." << std::endl;
+    GenerateGlobalSummary(gState.results.size());
+    TString timestamp = TString::Format("_%s", FormatCurrentTime("%b %e %Y_%H:%M:%S").c_str());
+    timestamp.ReplaceAll(" ", "_");  // Fix spaces in date
+    timestamp.ReplaceAll(":", "-");  // Fix colons in time
+    TString report = TString::Format("ExorcismReport_%s%s_watch", gState.currentLadder.c_str(), timestamp.Data());
+
+    // JSON/CSV are not streamed while watching: write the final state in one go
+    gState.stream = OpenResultStream(report);
+    if (gState.stream) {
+        ScopedStage stage(STAGE_REPORT_STREAM);
+        for (const auto& validation : gState.results) {
+            gState.stream->Write(gState.currentLadder, validation, SummarizeDirectory(validation));
+        }
+    }
+    SaveReports(report);
+    SaveValidationCache();
+    WaitForPdfReports();
+    PrintReportNames(report);
+#else
+    std::cerr << "Error: Watch mode needs inotify and is only available on Linux" << std::endl;
+#endif
+}
+
+/*
+ * PrintRunFooter:
+ * Cache statistics, purged quarantine folders and the performance
+ * profile at the end of a single-ladder run
+ */
+void PrintRunFooter(std::future<int>& quarantinePurge) {
+    if (!gCache.filePath.empty()) {
+        std::cout << "\nValidation cache: " << gCache.hits << " verdicts reused, "
+                  << gCache.misses << " files checked (" << gCache.filePath << ")" << std::endl;
+    }
+
+    if (quarantinePurge.valid()) {
+        std::cout << "Purged " << quarantinePurge.get()
+                  << " quarantine folders of earlier runs" << std::endl;
+    }
+
+    PrintProfile();
+}
+
+// ===================================================================
+// Main Function - Exorcism
+// ===================================================================
+/*
+ * Exorcism:
+ * Main driver function that orchestrates the entire validation process.
+ * Performs complete validation of ladder test data directories including:
+ * - Directory discovery
+ * - Two-pass validation (before/after cleanup)
+ * - Comprehensive report generation
+ * - Interactive cleanup of problematic files
+ *
+ * Parameters:
+ *   options - Space-separated option string (see ParseOptions),
+ *             e.g. root 'Exorcism.C("--workers=8")'
+ *
+ * Operation Flow:
+ * 1. Initializes global state
+ * 2. Discovers validation directories
+ * 3. First validation pass (pre-cleanup)
+ * 4. Generates initial reports
+ * 5. Performs interactive cleanup (ends here with --cleanup=none)
+ * 6. Second validation pass (post-cleanup, changed folders only)
+ * 7. Generates final reports
+ * 8. Provides completion summary
+ *
+ * Returns:
+ *   0, or with --verdict-only the worst STATUS_* level (see RunVerdict);
+ *   EXIT_INVALID_OPTIONS if an option was rejected
+ */
+int Exorcism(const char* options = "") {
+    // ===================================================================
+    // INITIALIZATION
+    // ===================================================================
+    /* A mistyped option must not fall back to a default (e.g. the cleanup mode) */
+    if (!ParseOptions(options)) {
+        std::cerr << "Error: Invalid options, nothing was validated or deleted" << std::endl;
+        PrintUsage();
+        return EXIT_INVALID_OPTIONS;
+    }
+    gProfile.Reset();  // Instrumentation covers this call only
+
+    /* Nothing of an earlier call in this session may leak into this one */
+    gState = GlobalState();
+    {
+        std::lock_guard<std::mutex> lock(gSnapshotsMutex);
+        gSnapshots.clear();
+    }
+
+    /* Summary of a sharded batch run, nothing is validated */
+    if (!gOptions.shardResults.empty()) {
+        return RunShardMerge();
+    }
+
+    /* Several ladders at once: separate driver without cleanup */
+    if (!gOptions.batchRoots.empty()) {
+        return RunBatch();
+    }
+
+    /* Set current ladder name from working directory */
+    gState.currentLadder = gSystem->BaseName(gSystem->WorkingDirectory());
+    
+    /* Print startup banner */
+    std::cout << "Starting EXORCISM validation for ladder: " 
+              << gState.currentLadder << std::endl;
+    std::cout << "====================================================" << std::endl;
+
+    /* Load verdicts of previous runs */
+    OpenValidationCache(gSystem->WorkingDirectory());
+
+    /* Continuous validation instead of the validate-clean-revalidate cycle */
+    if (gOptions.watch) {
+        RunWatch();
+        return 0;
+    }
+
+    /* Old quarantine folders are purged while this run validates */
+    std::future<int> quarantinePurge;
+    if (gOptions.purgeQuarantine) {
+        quarantinePurge = StartQuarantinePurge(gSystem->WorkingDirectory());
+    }
+
+    // ===================================================================
+    // DIRECTORY DISCOVERY
+    // ===================================================================
+    /* Find all candidate directories for validation */
+    std::vector<TString> directories = FindValidationDirectories();
+    if (directories.empty()) {
+        std::cout << "No validation directories found!" << std::endl;
+        return gOptions.verdictOnly ? STATUS_DIRECTORY_ERROR : 0;  // Exit if nothing to validate
+    }
+    
+    std::cout << "Found " << directories.size() 
+              << " directories to validate" << std::endl;
+    std::cout << "====================================================\n" << std::endl;
+
+    /* Status codes only: short-circuiting validators, no reports or cleanup */
+    if (gOptions.verdictOnly) {
+        return RunVerdict(directories);
+    }
+
+    // ===================================================================
+    // FIRST VALIDATION PASS (BEFORE CLEANUP)
+    // ===================================================================
+    std::cout << "\n===== FIRST VALIDATION PASS (BEFORE CLEANUP) =====" << std::endl;
+    
+    /* Create timestamp for report filenames */
+    TString timestamp = TString::Format("_%s", FormatCurrentTime("%b %e %Y_%H:%M:%S").c_str());
+    timestamp.ReplaceAll(" ", "_");  // Fix spaces in date
+    timestamp.ReplaceAll(":", "-");  // Fix colons in time
+    
+    /* Create report filename with ladder name and timestamp */
+    TString beforeReport = TString::Format("ExorcismReport_%s%s_before", 
+                                         gState.currentLadder.c_str(), timestamp.Data());
+
+    /* Baseline of the delta report, looked up before this run adds its own */
+    TString previousReport;
+    if (gOptions.diff) {
+        previousReport = gOptions.diffBase.empty()
+            ? FindPreviousReport(gSystem->WorkingDirectory(), gState.currentLadder)
+            : TString(gOptions.diffBase.c_str());
+    }
+    gState.stream = OpenResultStream(beforeReport);  // JSON/CSV are written while validating
+    gState.journal = OpenJournal(gSystem->pwd());    // Checkpoints the pass until its reports are saved
+    
+    /* Process each directory and generate reports */
+    ValidateDirectories(directories);
+    
+    /* Generate initial summary statistics */
+    GenerateGlobalSummary(directories.size());
+
+    /* What changed since the earlier report */
+    if (gOptions.diff) {
+        SaveDeltaReport(TString::Format("ExorcismDelta_%s%s.txt", gState.currentLadder.c_str(), timestamp.Data()),
+                        previousReport);
+    }
+    
+    // ===================================================================
+    // SAVE PRE-CLEANUP REPORTS
+    // ===================================================================
+    /* Save reports in the selected formats */
+    std::cout << "\nSaving pre-cleanup reports..." << std::endl;
+    SaveReports(beforeReport);
+    SaveValidationCache();  // Keep first-pass verdicts even if cleanup is aborted
+    if (gState.journal) gState.journal->Remove();
+    gState.journal.reset();  // The post-cleanup pass is not checkpointed
+
+    /* Report only: no cleanup, so a second pass would change nothing */
+    if (gOptions.cleanupMode == CLEANUP_NONE) {
+        WaitForPdfReports();
+        std::cout << "\nValidation complete! Reports generated (no cleanup):" << std::endl;
+        PrintReportNames(beforeReport);
+        PrintRunFooter(quarantinePurge);
+        return 0;
+    }
+
+    // ===================================================================
+    // INTERACTIVE CLEANUP
+    // ===================================================================
+    /* Perform guided cleanup of problematic files */
+    std::map<TString, int> touchedFolders = Extra_Omnes(gState.results);
+    
+    // ===================================================================
+    // PREPARE FOR SECOND VALIDATION PASS
+    // ===================================================================
+    /* Reset global state while preserving ladder name and first-pass results */
+    std::string ladderName = gState.currentLadder;  // Save
+    std::vector<DirectoryValidation> firstPassResults = std::move(gState.results);
+    gState = GlobalState();  // Reset all counters and reports
+    gState.currentLadder = ladderName;  // Restore
+    
+    // ===================================================================
+    // SECOND VALIDATION PASS (AFTER CLEANUP)
+    // ===================================================================
+    std::cout << "\n===== SECOND VALIDATION PASS (AFTER CLEANUP) =====" << std::endl;
+    
+    /* Create report filename for post-cleanup */
+    TString afterReport = TString::Format("ExorcismReport_%s%s_after", 
+                                        gState.currentLadder.c_str(), timestamp.Data());
+    gState.stream = OpenResultStream(afterReport);
+    
+    /* Re-validate only the folders changed by cleanup */
+    RevalidateChangedDirectories(std::move(firstPassResults), touchedFolders);
+    
+    /* Generate post-cleanup summary */
+    GenerateGlobalSummary(directories.size());
+    
+    // ===================================================================
+    // SAVE POST-CLEANUP REPORTS
+    // ===================================================================
+    /* Save final reports */
+    std::cout << "\nSaving post-cleanup reports..." << std::endl;
+    SaveReports(afterReport);
+    SaveValidationCache();
+    WaitForPdfReports();  // Both PDFs were rendered in the background
+
+    // ===================================================================
+    // COMPLETION SUMMARY
+    // ===================================================================
+    std::cout << "\nValidation complete! Two sets of reports generated:" << std::endl;
+    std::cout << "Pre-cleanup reports:" << std::endl;
+    PrintReportNames(beforeReport);
+    
+    std::cout << "\nPost-cleanup reports:" << std::endl;
+    PrintReportNames(afterReport);
+
+    PrintRunFooter(quarantinePurge);
+    return 0;
+}
+
+/*
+ * main:
+ * Entry point of the standalone executable (see Makefile). Cling uses
+ * Exorcism() directly when the file is run as a ROOT macro; tools that
+ * include this file (ExorcismBench.C) define EXORCISM_NO_MAIN.
+ */
+#if !defined(__CLING__) && !defined(EXORCISM_NO_MAIN)
+int main(int argc, char** argv) {
+    // No canvases are ever shown, only written to PDF
+    gROOT->SetBatch(kTRUE);
+
+    // Forward command-line arguments as an option string
+    TString options;
+    for (int i = 1; i < argc; i++) {
+        if (i > 1) options += " ";
+        options += argv[i];
+    }
+    return Exorcism(options.Data());  // Verdict-only mode: worst STATUS_* level; 4 = invalid options
+}
+#endif